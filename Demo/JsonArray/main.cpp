@@ -58,7 +58,11 @@ using namespace std::chrono;
 using Json = nlohmann::json;
 
 // Definition of a binary structure type corresponding to the JSON
-using Trade = vector<std::tuple<uint64_t, double, double, double, std::chrono::nanoseconds, bool, bool>>;
+// Prices and quantities are kept as exact decimals with the number of digits used in the JSON
+using Price = FixedDecimal<2>;
+using Qty = FixedDecimal<3>;
+using QuoteQty = FixedDecimal<4>;
+using Trade = vector<std::tuple<uint64_t, Price, Qty, QuoteQty, std::chrono::nanoseconds, bool, bool>>;
 
 // Function to convert JSON data to a Trade structure
 Trade FromJson(const Json &json)
@@ -67,9 +71,9 @@ Trade FromJson(const Json &json)
     for (const auto& item : json) {
         trade.emplace_back(
             item.at("id").get<uint64_t>(),
-            stod(item.at("price").get<string>()),
-            stod(item.at("qty").get<string>()),
-            stod(item.at("quoteQty").get<string>()),
+            Price::Parse(item.at("price").get<string>()),
+            Qty::Parse(item.at("qty").get<string>()),
+            QuoteQty::Parse(item.at("quoteQty").get<string>()),
             chrono::nanoseconds(item.at("time").get<int64_t>() * 1'000'000), //   
             item.at("isBuyerMaker").get<bool>(),
             item.at("isBestMatch").get<bool>()
@@ -81,21 +85,14 @@ Trade FromJson(const Json &json)
 // Function to convert a Trade object to its JSON representation
 void ToJson(const Trade& trade, Json& json)
 {
-    auto FormatDouble = [](double value, int precision) -> std::string
-    {
-        std::ostringstream oss;
-        oss << std::fixed << std::setprecision(precision) << value;
-        return oss.str();
-    };
-
     json = Json::array();
     for (const auto& [id, price, qty, quoteQty, time, isBuyerMaker, isBestMatch] : trade)
         json.push_back(
         {
             {"id", id},
-            {"price", FormatDouble(price, 2)},    // 2   
-            {"qty", FormatDouble(qty, 3)},        // 3   
-            {"quoteQty", FormatDouble(quoteQty, 4)}, // 4   
+            {"price", price.ToString()},    // 2   
+            {"qty", qty.ToString()},        // 3   
+            {"quoteQty", quoteQty.ToString()}, // 4   
             {"time", std::chrono::duration_cast<std::chrono::milliseconds>(time).count()},
             {"isBuyerMaker", isBuyerMaker},
             {"isBestMatch", isBestMatch}
@@ -105,7 +102,7 @@ void ToJson(const Trade& trade, Json& json)
 // Definition of a serializer/deserializer
 using TradeSerdes = Custom<
     Json,
-    Vector<Tuple<UInt64, Double, Double, Double, DateTime, Bool, Bool>>,
+    Vector<Tuple<UInt64, Decimal<2, VarInt64>, Decimal<3, VarInt64>, Decimal<4, VarInt64>, DateTime, Bool, Bool>>,
     FromJson,
     ToJson>;
 
@@ -117,7 +114,7 @@ int main()
 
     // Serialization
     auto buffer = Serialize<TradeSerdes>(json);
-    assert(buffer.size() == 130);
+    assert(buffer.size() == 86);
 
     // Deserialization into data for use in the program
     Trade trade;
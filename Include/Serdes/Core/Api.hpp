@@ -15,14 +15,44 @@
 */
 
 //------------------------------------------------------------------------------
+#include <tuple>
+#include <vector>
+#include <iterator>
 #include "Concepts.hpp"
 #include "Helpers.hpp"
+#include "Skip.hpp"
 #include "Default.hpp"
 #include "Typedefs.hpp"
 
 //------------------------------------------------------------------------------
 namespace serdes
 {
+    namespace details
+    {
+        /// Determines whether Sizeof(value) of the serdes or of a nested serdes does the work
+        /// of serialization (for example, compression); such serdes declare costlySizeof
+        template<CSerdes TSerdes>
+        consteval
+        bool HasCostlySizeof()
+        {
+            if constexpr (requires { { TSerdes::costlySizeof } -> std::convertible_to<bool>; })
+                return TSerdes::costlySizeof;
+            else if constexpr (CBasedSerdes<TSerdes>)
+                return HasCostlySizeof<typename TSerdes::BaseSerdes>();
+            else if constexpr (CListSerdes<TSerdes>)
+                return []<typename ...TNested>(std::tuple<TNested...> *)
+                {
+                    return (HasCostlySizeof<TNested>() || ...);
+                }(static_cast<typename TSerdes::SerdesList *>(nullptr));
+            else if constexpr (requires { typename TSerdes::ElementSerdes; })
+                return HasCostlySizeof<typename TSerdes::ElementSerdes>();
+            else if constexpr (CIndirectSerdes<TSerdes>)
+                return HasCostlySizeof<typename TSerdes::SerdesType>();
+            else
+                return false;
+        }
+    }
+
     /// Function returns the buffer type (static or dynamic)
     template<CSerdes ...TSerdes>
     [[nodiscard]] static consteval
@@ -86,7 +116,8 @@ namespace serdes
     }
 
     /// Serialization into an automatically created buffer
-    /// The buffer type is chosen automatically based on the serdes type
+    /// The buffer type is chosen automatically based on the serdes type; values of serdes
+    /// whose Sizeof(value) is costly (see details::HasCostlySizeof) are appended to a growing buffer
     /// This function is intended for the simplest use cases. For more complex scenarios,
     /// explicit buffer management mechanisms should be used.
     template<CSerdes ...TSerdes, typename ...TValues>
@@ -100,6 +131,13 @@ namespace serdes
             SerializeTo<TSerdes...>(buf.begin(), values...);
             return buf;
         }
+        // Computing the size first would repeat the work of serialization
+        else if constexpr (details::HasCostlySizeof<SerdesT<TSerdes...>>())
+        {
+            std::vector<uint8_t> buf;
+            SerializeTo<TSerdes...>(std::back_inserter(buf), values...);
+            return buf;
+        }
         else
         {
             std::vector<uint8_t> buf(Sizeof<TSerdes...>(values...));
@@ -0,0 +1,207 @@
+#ifndef SERDES_CORE_BATCH_HPP
+#define SERDES_CORE_BATCH_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serialization of batches of small messages
+
+    @details
+        A batch is a sequence of length-framed records written back-to-back:
+
+            [length 1][message 1][length 2][message 2] ...
+
+        where each length is UInt32. The size of the whole batch is determined
+        first, so the buffer is allocated once. For serdes with a static buffer
+        the sizes are known at compile time and no values are examined; for
+        dynamic serdes the size of each message is computed once and used both
+        for the buffer size and for the record length. The range of messages is
+        traversed twice through a constant reference, so it must be a forward
+        range iterable when const (views such as std::views::filter are not).
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <vector>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Typedefs.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Serdes of the record length in a batch
+        using BatchLengthSerdes = UInt32;
+
+        /// Range of messages that can be traversed more than once through a constant reference
+        template<typename TRange>
+        concept CBatchRange = std::ranges::forward_range<const TRange>;
+
+        /// Sizes of the messages of a batch
+        template<CSerdes TSerdes>
+        struct BatchSizes
+        {
+            /// Message sizes (empty for serdes with a static buffer)
+            std::vector<uint32_t> sizes;
+
+            /// Size of the whole batch
+            size_t total = 0;
+
+            template<CBatchRange TRange>
+            explicit BatchSizes(const TRange &values)
+            {
+                constexpr size_t lengthSize = BatchLengthSerdes::Sizeof();
+
+                if constexpr (TSerdes::GetBufferType() == BufferType::Static && std::ranges::sized_range<const TRange>)
+                    total = std::ranges::size(values) * (lengthSize + TSerdes::Sizeof());
+                else
+                {
+                    if constexpr (std::ranges::sized_range<const TRange>)
+                        sizes.reserve(std::ranges::size(values));
+
+                    for(const auto &value: values)
+                    {
+                        const uint32_t size = TSerdes::Sizeof(value);
+                        if(size == WRONG_SIZE)
+                            utils::Throw<std::length_error>("message size exceeds the allowed limit");
+                        sizes.push_back(size);
+                        total += lengthSize + size;
+                    }
+                }
+            }
+
+            [[nodiscard]] constexpr
+            uint32_t operator[](size_t i) const
+            {
+                if constexpr (TSerdes::GetBufferType() == BufferType::Static)
+                    return TSerdes::Sizeof();
+                else
+                    return sizes[i];
+            }
+        };
+
+        /// Writes the records of a batch
+        template<CSerdes TSerdes, COutputIterator TOutputIterator, CBatchRange TRange>
+        constexpr
+        TOutputIterator SerializeRecords(TOutputIterator bufpos, const TRange &values, const BatchSizes<TSerdes> &sizes)
+        {
+            size_t i = 0;
+            for(const auto &value: values)
+            {
+                bufpos = BatchLengthSerdes::SerializeTo(bufpos, sizes[i++]);
+                bufpos = TSerdes::SerializeTo(bufpos, value);
+            }
+            return bufpos;
+        }
+    }
+
+    /// Determines the buffer size required to serialize a batch of messages
+    template<CSerdes TSerdes, details::CBatchRange TRange>
+    [[nodiscard]]
+    size_t SizeofBatch(const TRange &values)
+    {
+        return details::BatchSizes<TSerdes>(values).total;
+    }
+
+    /// Serializes a batch of messages into an external buffer
+    /// @param bufpos Iterator pointing to a buffer of sufficient size (see SizeofBatch)
+    /// @param values Range of messages
+    /// @return Iterator pointing to the buffer position immediately after the batch
+    template<CSerdes TSerdes, COutputIterator TOutputIterator, details::CBatchRange TRange>
+    TOutputIterator SerializeBatchTo(TOutputIterator bufpos, const TRange &values)
+    {
+        return details::SerializeRecords<TSerdes>(bufpos, values, details::BatchSizes<TSerdes>(values));
+    }
+
+    /// Appends a batch of messages to a byte container, resizing it once
+    /// @param values Range of messages
+    /// @param sink Container of bytes, for example std::vector<uint8_t>
+    /// @return Size of the appended batch
+    template<CSerdes TSerdes, details::CBatchRange TRange, std::ranges::random_access_range TSink>
+    requires requires(TSink &sink, size_t size) { sink.resize(size); }
+    size_t SerializeBatch(const TRange &values, TSink &sink)
+    {
+        const details::BatchSizes<TSerdes> sizes(values);
+        const size_t offset = std::ranges::size(sink);
+
+        sink.resize(offset + sizes.total);
+        details::SerializeRecords<TSerdes>(std::ranges::begin(sink) + offset, values, sizes);
+        return sizes.total;
+    }
+
+    /// Serializes a batch of messages into an automatically created buffer
+    template<CSerdes TSerdes, details::CBatchRange TRange>
+    [[nodiscard]]
+    std::vector<uint8_t> SerializeBatch(const TRange &values)
+    {
+        std::vector<uint8_t> buf;
+        SerializeBatch<TSerdes>(values, buf);
+        return buf;
+    }
+
+    /// Deserializes the messages of a batch one by one
+    /// @param first Iterator pointing to the first record
+    /// @param last Iterator pointing to the end of the batch
+    /// @param callback Callable entity taking a reference to a message. The message object is reused
+    /// for the next record, so it may be moved from but must not be referenced later.
+    /// If the callback returns bool, false stops the deserialization.
+    /// @return Iterator pointing to the first record that was not deserialized
+    /// @throw std::runtime_error if a record is truncated or its length does not match the message
+    template<CSerdes TSerdes, std::random_access_iterator TInputIterator, typename TCallback>
+    requires CInputIterator<TInputIterator> && std::invocable<TCallback &, ValueT<TSerdes> &>
+    TInputIterator DeserializeBatch(TInputIterator first, TInputIterator last, TCallback &&callback)
+    {
+        using LengthSerdes = details::BatchLengthSerdes;
+
+        ValueT<TSerdes> value{};
+        while(first != last)
+        {
+            if(last - first < static_cast<std::iter_difference_t<TInputIterator>>(LengthSerdes::Sizeof()))
+                utils::Throw<std::runtime_error>("truncated record length");
+
+            ValueT<LengthSerdes> length{0};
+            TInputIterator message = LengthSerdes::DeserializeFrom(first, length);
+            if(last - message < static_cast<std::iter_difference_t<TInputIterator>>(length))
+                utils::Throw<std::runtime_error>(std::format("truncated record of length {}", length));
+
+            const TInputIterator next = message + length;
+            if(TSerdes::DeserializeFrom(message, value) != next)
+                utils::Throw<std::runtime_error>(std::format("record length {} does not match the message", length));
+            first = next;
+
+            if constexpr (std::is_void_v<std::invoke_result_t<TCallback &, ValueT<TSerdes> &>>)
+                callback(value);
+            else if(!callback(value))
+                break;
+        }
+        return first;
+    }
+
+    /// Deserializes the messages of a batch into an output iterator
+    /// @return Output iterator past the last message written
+    template<CSerdes TSerdes, std::random_access_iterator TInputIterator, typename TOutputIterator>
+    requires CInputIterator<TInputIterator> && std::output_iterator<TOutputIterator, ValueT<TSerdes> &&>
+    TOutputIterator DeserializeBatch(TInputIterator first, TInputIterator last, TOutputIterator output)
+    {
+        DeserializeBatch<TSerdes>(first, last, [&output](ValueT<TSerdes> &value)
+        {
+            *output++ = std::move(value);
+        });
+        return output;
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,172 @@
+#ifndef SERDES_CORE_BITFIELD_HPP
+#define SERDES_CORE_BITFIELD_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for values occupying a given number of bits
+
+    @details
+        Flags, small enums and short counters need only a few bits. A BitField
+        serialized on its own occupies ceil(N / 8) bytes, but consecutive bit
+        fields inside a Tuple (and so inside a Struct) share bytes: they are
+        packed into a word starting from the least significant bit, in the
+        order of the fields (see Tuple.hpp).
+
+            using OrderStatus = Struct<Status, Tuple<Bits<3>, Flag, Flag, BitField<Side, 2>, Bits<12>>,
+                                       &Status::state, &Status::filled, &Status::cancelled, &Status::side, &Status::venue>;
+            static_assert(OrderStatus::Sizeof() == 3);
+
+        Signed values are stored in two's complement and sign-extended when
+        deserialized; enums are stored as their underlying values.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <cstdint>
+#include <concepts>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "BitStream.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Integer type of an enum or the type itself
+        template<typename T>
+        using BitFieldInteger = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type;
+
+        /// Smallest unsigned integer with the given number of bits
+        template<unsigned bitCount>
+        using LeastUnsigned = std::conditional_t<bitCount <= 8, uint8_t,
+                              std::conditional_t<bitCount <= 16, uint16_t,
+                              std::conditional_t<bitCount <= 32, uint32_t, uint64_t>>>;
+
+        /// Writes the lowest bytes of a word, starting from the least significant one
+        template<COutputIterator TOutputIterator>
+        constexpr
+        TOutputIterator SerializeBitWord(TOutputIterator bufpos, uint64_t word, unsigned bytes)
+        {
+            using IteratorValueType = typename std::iterator_traits<TOutputIterator>::value_type;
+            using TBuffer = std::conditional_t<std::is_same_v<IteratorValueType, void>, uint8_t, IteratorValueType>;
+
+            for(unsigned i = 0; i < bytes; i++, word >>= 8)
+                *bufpos++ = static_cast<TBuffer>(static_cast<uint8_t>(word));
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        constexpr
+        TInputIterator DeserializeBitWord(TInputIterator bufpos, uint64_t &word, unsigned bytes)
+        {
+            word = 0;
+            for(unsigned i = 0; i < bytes; i++)
+                word |= static_cast<uint64_t>(static_cast<uint8_t>(*bufpos++)) << 8 * i;
+            return bufpos;
+        }
+    }
+
+    /// @tparam T Type of the value (integer, bool or enum)
+    /// @tparam bits Number of bits
+    template<typename T, unsigned bits>
+    requires (std::integral<details::BitFieldInteger<T>>
+              && bits >= 1 && bits <= 8 * sizeof(T))
+    struct BitField
+    {
+        using ValueType = T;
+
+        /// Number of bits
+        static constexpr unsigned bitCount = bits;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{bits};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::BitField; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Static; }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof() { return (bits + 7) / 8; }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const ValueType &) { return Sizeof(); }
+
+        /// Converts the value to the bits of the field
+        /// @throw std::out_of_range if the value does not fit into the field
+        [[nodiscard]] static constexpr
+        uint64_t ToBits(const ValueType &value)
+        {
+            using Integer = details::BitFieldInteger<T>;
+            const auto integer = static_cast<Integer>(value);
+
+            bool fits;
+            if constexpr (std::is_signed_v<Integer>)
+                fits = bits == 64 || (integer >= -(int64_t{1} << (bits - 1)) && integer < (int64_t{1} << (bits - 1)));
+            else
+                fits = bits == 64 || static_cast<uint64_t>(integer) <= details::LowBits(bits);
+
+            if(!fits)
+                utils::Throw<std::out_of_range>("value does not fit into the bit field");
+
+            return static_cast<uint64_t>(integer) & details::LowBits(bits);
+        }
+
+        /// Converts the lowest bits of the word to the value
+        [[nodiscard]] static constexpr
+        ValueType FromBits(uint64_t word) noexcept
+        {
+            using Integer = details::BitFieldInteger<T>;
+
+            word &= details::LowBits(bits);
+            if constexpr (std::is_signed_v<Integer> && bits < 64)
+                if(word >> (bits - 1))
+                    word |= ~details::LowBits(bits);
+
+            if constexpr (std::same_as<Integer, bool>)
+                return static_cast<ValueType>(word != 0);
+            else
+                return static_cast<ValueType>(static_cast<Integer>(word));
+        }
+
+        template<COutputIterator TOutputIterator>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const ValueType &value)
+        {
+            return details::SerializeBitWord(bufpos, ToBits(value), Sizeof());
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, ValueType &value)
+        {
+            uint64_t word = 0;
+            bufpos = details::DeserializeBitWord(bufpos, word, Sizeof());
+            value = FromBits(word);
+            return bufpos;
+        }
+    };
+
+    namespace details
+    {
+        /// Bit field serdes, packed with the neighbouring bit fields inside tuples
+        template<typename TSerdes>
+        concept CBitFieldSerdes = requires
+        {
+            { TSerdes::bitCount } -> std::convertible_to<unsigned>;
+        } && (TSerdes::GetTypeId() == TypeId::BitField);
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
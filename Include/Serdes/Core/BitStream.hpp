@@ -0,0 +1,160 @@
+#ifndef SERDES_CORE_BITSTREAM_HPP
+#define SERDES_CORE_BITSTREAM_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Writing and reading of bit fields packed into bytes
+
+    @details
+        Bits are packed starting from the least significant bit of the first
+        byte; a field written with a single call may cross byte boundaries.
+        The last byte is padded with zero bits.
+
+        BitWriter accumulates bits in a 64-bit word and outputs whole words, so
+        serializers with per-value bit fields cost a few instructions per field.
+        BitCounter has the same interface and counts bits without writing them,
+        so one encoding function computes both the exact size and the data.
+        BitReader reads the bytes one at a time as needed and never reads past
+        the last byte that contains the requested bits.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include "Concepts.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Mask of the lowest count bits (count <= 64)
+        [[nodiscard]] constexpr
+        uint64_t LowBits(unsigned count) noexcept
+        {
+            return count < 64 ? (uint64_t{1} << count) - 1 : ~uint64_t{0};
+        }
+
+        /// Counts the bits that would be written by BitWriter
+        struct BitCounter
+        {
+            uint64_t bits = 0;
+
+            constexpr
+            void Write(uint64_t, unsigned count) noexcept { bits += count; }
+
+            /// Number of bytes occupied by the bits
+            [[nodiscard]] constexpr
+            uint64_t Bytes() const noexcept { return (bits + 7) / 8; }
+        };
+
+        /// Writes bit fields to an output iterator
+        template<COutputIterator TOutputIterator>
+        class BitWriter
+        {
+            using IteratorValueType = typename std::iterator_traits<TOutputIterator>::value_type;
+            using TBuffer = std::conditional_t<std::is_same_v<IteratorValueType, void>, uint8_t, IteratorValueType>;
+
+        public:
+            constexpr explicit
+            BitWriter(TOutputIterator bufpos) : _bufpos(bufpos) {}
+
+            /// Writes the lowest count bits of the value (count <= 64)
+            constexpr
+            void Write(uint64_t value, unsigned count)
+            {
+                if(count == 0)
+                    return;
+
+                value &= LowBits(count);
+                _word |= value << _filled;
+
+                if(_filled + count < 64)
+                {
+                    _filled += count;
+                    return;
+                }
+
+                Put(_word, 8);
+                _word = _filled ? value >> (64 - _filled) : 0;
+                _filled = _filled + count - 64;
+            }
+
+            /// Writes the remaining bits, padding the last byte with zeros
+            /// @return Iterator pointing to the buffer position immediately after the written bytes
+            constexpr
+            TOutputIterator Finish()
+            {
+                Put(_word, (_filled + 7) / 8);
+                _word = 0;
+                _filled = 0;
+                return _bufpos;
+            }
+
+        private:
+            constexpr
+            void Put(uint64_t word, unsigned bytes)
+            {
+                for(unsigned i = 0; i < bytes; i++, word >>= 8)
+                    *_bufpos++ = static_cast<TBuffer>(static_cast<uint8_t>(word));
+            }
+
+            TOutputIterator _bufpos;
+            uint64_t _word = 0;
+            unsigned _filled = 0;
+        };
+
+        /// Reads bit fields from an input iterator
+        template<CInputIterator TInputIterator>
+        class BitReader
+        {
+        public:
+            constexpr explicit
+            BitReader(TInputIterator bufpos) : _bufpos(bufpos) {}
+
+            /// Reads a field of count bits (count <= 64)
+            [[nodiscard]] constexpr
+            uint64_t Read(unsigned count)
+            {
+                // Fields longer than 56 bits may not fit into the word with the remaining bits
+                if(count > 56)
+                {
+                    const uint64_t low = Read(32);
+                    return low | Read(count - 32) << 32;
+                }
+
+                while(_available < count)
+                {
+                    _word |= static_cast<uint64_t>(static_cast<uint8_t>(*_bufpos++)) << _available;
+                    _available += 8;
+                }
+
+                const uint64_t value = _word & LowBits(count);
+                _word = count < 64 ? _word >> count : 0;
+                _available -= count;
+                return value;
+            }
+
+            [[nodiscard]] constexpr
+            bool ReadBit() { return Read(1) != 0; }
+
+            /// Discards the padding bits of the last byte read
+            /// @return Iterator pointing to the byte following the last byte read
+            [[nodiscard]] constexpr
+            TInputIterator Finish() const noexcept { return _bufpos; }
+
+        private:
+            TInputIterator _bufpos;
+            uint64_t _word = 0;
+            unsigned _available = 0;
+        };
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
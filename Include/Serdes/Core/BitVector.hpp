@@ -0,0 +1,320 @@
+#ifndef SERDES_CORE_BITVECTOR_HPP
+#define SERDES_CORE_BITVECTOR_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes templates for bit-packed boolean sequences and std::bitset
+
+    @details
+        Flags are packed 8 per byte, starting from the least significant bit
+        of the first byte (the bit order of BitStream.hpp); unused bits of the
+        last byte are zero.
+
+        Serialized data format:
+
+            BitRange:    [n][ceil(n / 8) bytes]
+            BitArray<N>: [ceil(N / 8) bytes]
+
+        Flags stored as contiguous single-byte objects (std::array<bool, N>,
+        bool[], std::vector<uint8_t>) are packed and unpacked 8 at a time with
+        multiplications on little-endian platforms; other ranges
+        (std::vector<bool>) are processed with a 64-bit accumulator. As with
+        other ranges, any nonzero byte is packed as a set flag, and unpacked
+        flags are 0 or 1.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <bit>
+#include <array>
+#include <bitset>
+#include <ranges>
+#include <limits>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Range of single-byte flags stored contiguously
+        template<typename TRange>
+        concept CContiguousFlags = std::ranges::contiguous_range<TRange>
+                                   && sizeof(std::ranges::range_value_t<TRange>) == 1
+                                   && (std::same_as<std::ranges::range_value_t<TRange>, bool>
+                                       || std::unsigned_integral<std::ranges::range_value_t<TRange>>);
+
+        /// Packs 8 flags (bytes equal to 0 or 1) into a byte
+        [[nodiscard]] constexpr
+        uint8_t PackFlags(uint64_t flags) noexcept
+        {
+            // With little-endian loading, flag k is bit 8k; the multiplication gathers bit 8k into bit 56 + k
+            return static_cast<uint8_t>((flags * 0x0102040810204080ull) >> 56);
+        }
+
+        /// Converts 8 bytes into flags: nonzero bytes become 1
+        [[nodiscard]] constexpr
+        uint64_t NormalizeFlags(uint64_t bytes) noexcept
+        {
+            // The low 7 bits of a nonzero byte carry into the bit 7 after adding 0x7F
+            return ((((bytes & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | bytes) & 0x8080808080808080ull) >> 7;
+        }
+
+        /// Unpacks a byte into 8 flags (bytes equal to 0 or 1)
+        [[nodiscard]] constexpr
+        uint64_t UnpackFlags(uint8_t byte) noexcept
+        {
+            // Bit k is replicated into byte k, where it is moved to the position 7 and then to the position 0
+            return ((((byte * 0x0101010101010101ull) & 0x8040201008040201ull) + 0x7F7F7F7F7F7F7F7Full)
+                    & 0x8080808080808080ull) >> 7;
+        }
+
+        /// Packs a forward range of flags
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        constexpr
+        TOutputIterator SerializeFlags(TOutputIterator bufpos, const TRange &range, size_t size)
+        {
+            using IteratorValueType = typename std::iterator_traits<TOutputIterator>::value_type;
+            using TBuffer = std::conditional_t<std::is_same_v<IteratorValueType, void>, uint8_t, IteratorValueType>;
+
+            size_t i = 0;
+
+            if constexpr (CContiguousFlags<TRange> && std::endian::native == std::endian::little)
+                if(!std::is_constant_evaluated())
+                {
+                    const auto *data = reinterpret_cast<const uint8_t *>(std::ranges::data(range));
+                    for(; i + 8 <= size; i += 8)
+                    {
+                        uint64_t flags;
+                        std::memcpy(&flags, data + i, 8);
+
+                        // Integer elements may hold values other than 0 and 1
+                        if constexpr (!std::same_as<std::ranges::range_value_t<TRange>, bool>)
+                            flags = NormalizeFlags(flags);
+                        *bufpos++ = static_cast<TBuffer>(PackFlags(flags));
+                    }
+                }
+
+            // Remaining flags are accumulated in a word that is written 8 bytes at a time
+            auto element = std::ranges::next(std::ranges::begin(range), static_cast<std::ranges::range_difference_t<TRange>>(i));
+            uint64_t word = 0;
+            unsigned filled = 0;
+            for(; i < size; i++, ++element)
+            {
+                word |= static_cast<uint64_t>(static_cast<bool>(*element)) << filled;
+                if(++filled == 64)
+                {
+                    for(unsigned k = 0; k < 8; k++, word >>= 8)
+                        *bufpos++ = static_cast<TBuffer>(static_cast<uint8_t>(word));
+                    word = 0;
+                    filled = 0;
+                }
+            }
+
+            for(unsigned k = 0; k < filled; k += 8, word >>= 8)
+                *bufpos++ = static_cast<TBuffer>(static_cast<uint8_t>(word));
+
+            return bufpos;
+        }
+
+        /// Unpacks flags into a forward range of the given size
+        template<CInputIterator TInputIterator, std::ranges::forward_range TRange>
+        constexpr
+        TInputIterator DeserializeFlags(TInputIterator bufpos, TRange &range, size_t size)
+        {
+            size_t i = 0;
+
+            if constexpr (CContiguousFlags<TRange> && std::endian::native == std::endian::little)
+                if(!std::is_constant_evaluated())
+                {
+                    auto *data = reinterpret_cast<uint8_t *>(std::ranges::data(range));
+                    for(; i + 8 <= size; i += 8)
+                    {
+                        uint64_t flags = UnpackFlags(static_cast<uint8_t>(*bufpos++));
+                        std::memcpy(data + i, &flags, 8);
+                    }
+                }
+
+            auto element = std::ranges::next(std::ranges::begin(range), static_cast<std::ranges::range_difference_t<TRange>>(i));
+            while(i < size)
+            {
+                // A word is loaded from up to 8 bytes
+                uint64_t word = 0;
+                const size_t count = std::min<size_t>(64, size - i);
+                for(unsigned k = 0; k < count; k += 8)
+                    word |= static_cast<uint64_t>(static_cast<uint8_t>(*bufpos++)) << k;
+
+                for(size_t k = 0; k < count; k++, word >>= 1, ++element)
+                    *element = static_cast<bool>(word & 1);
+                i += count;
+            }
+
+            return bufpos;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Serdes template for bit-packed sequences of flags
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of flags
+    /// @tparam TValueType Sequential container of flags (e.g. std::vector<bool>)
+    template<
+        CSerdes TSizeSerdes,
+        std::ranges::range TValueType>
+    requires (TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+    struct BitRange
+    {
+        /// Serdes for serializing/deserializing the number of flags
+        using SizeSerdes = TSizeSerdes;
+
+        using ValueType = TValueType;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::BitRange; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        /// Number of bytes occupied by the given number of flags
+        [[nodiscard]] static constexpr
+        uint32_t ByteCount(uint64_t size) noexcept { return static_cast<uint32_t>((size + 7) / 8); }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            return utils::Safe<utils::policy::MaxValue>::Add(SizeSerdes::Sizeof(),
+                                                             ByteCount(std::numeric_limits<ValueT<SizeSerdes>>::max()));
+        }
+
+        /// @note This function returns WRONG_SIZE if the range size exceeds the maximum allowed value
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+
+            return utils::Safe<utils::policy::MaxValue>::Add(SizeSerdes::Sizeof(), ByteCount(size));
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+            return details::SerializeFlags(bufpos, range, size);
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            sequence.resize(size);
+            return details::DeserializeFlags(bufpos, sequence, size);
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            return details::Advance(bufpos, ByteCount(size));
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            ValueT<SizeSerdes> size{0};
+            if(!cursor.template Read<SizeSerdes>(size))
+                return false;
+
+            cursor.Finish();
+            cursor.Bytes(ByteCount(size));
+            return true;
+        }
+    };
+
+    //--------------------------------------------------------------------------
+    /// Serdes template for std::bitset
+    /// @tparam bitCount Number of bits
+    template<size_t bitCount>
+    requires (bitCount > 0 && bitCount / 8 < std::numeric_limits<uint32_t>::max())
+    struct BitArray
+    {
+        using ValueType = std::bitset<bitCount>;
+
+        /// Number of bits
+        static constexpr size_t arrayBits = bitCount;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{bitCount};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::BitArray; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Static; }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof() { return static_cast<uint32_t>((bitCount + 7) / 8); }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const ValueType &) { return Sizeof(); }
+
+        template<COutputIterator TOutputIterator>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const ValueType &value)
+        {
+            using IteratorValueType = typename std::iterator_traits<TOutputIterator>::value_type;
+            using TBuffer = std::conditional_t<std::is_same_v<IteratorValueType, void>, uint8_t, IteratorValueType>;
+
+            for(size_t first = 0; first < bitCount; first += 8)
+            {
+                uint8_t byte = 0;
+                for(size_t k = 0; k < 8 && first + k < bitCount; k++)
+                    byte |= static_cast<uint8_t>(value[first + k]) << k;
+                *bufpos++ = static_cast<TBuffer>(byte);
+            }
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, ValueType &value)
+        {
+            for(size_t first = 0; first < bitCount; first += 8)
+            {
+                const auto byte = static_cast<uint8_t>(*bufpos++);
+                for(size_t k = 0; k < 8 && first + k < bitCount; k++)
+                    value[first + k] = (byte >> k) & 1;
+            }
+
+            return bufpos;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
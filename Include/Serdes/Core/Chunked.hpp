@@ -0,0 +1,221 @@
+#ifndef SERDES_CORE_CHUNKED_HPP
+#define SERDES_CORE_CHUNKED_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for sequences divided into chunks of known byte length
+
+    @details
+        With the Sequence format the position of an element with a dynamic buffer
+        is known only after all preceding elements have been deserialized. The
+        Chunked serdes divides the elements into chunks of a fixed number of
+        elements and records the byte length of every chunk before the elements,
+        so the chunks can be located without deserializing them and decoded
+        in parallel (see the DeserializeFrom overload in Parallel.hpp).
+
+        Serialized data format:
+
+            [n][length of chunk 1] ... [length of chunk k][elements of chunk 1] ... [elements of chunk k]
+
+        where k = ceil(n / chunkSize), and n and the chunk lengths are serialized
+        with the size serdes.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <ranges>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements and the chunk lengths
+    /// @tparam TElementSerdes Serdes used to serialize/deserialize individual elements
+    /// @tparam TValueType Sequential container type
+    /// @tparam chunkSize Number of elements in a chunk (the last chunk may be shorter)
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType,
+        uint32_t chunkSize = 1024>
+    requires (TSizeSerdes::Sizeof() == 4 && chunkSize > 0)
+    struct Chunked
+    {
+        /// Serdes for serializing/deserializing the number of elements and the chunk lengths
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing elements
+        using ElementSerdes = TElementSerdes;
+
+        using ValueType = TValueType;
+
+        /// Number of elements in a chunk
+        static constexpr uint32_t chunkCapacity = chunkSize;
+
+        /// Parameters of the layout (see Fingerprint.hpp)
+        static constexpr std::array<uint64_t, 1> layoutParameters{chunkSize};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Chunked; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        /// Number of chunks for the given number of elements
+        [[nodiscard]] static constexpr
+        uint32_t ChunkCount(uint32_t size) noexcept { return size / chunkSize + (size % chunkSize != 0); }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+            constexpr uint32_t maxSize = std::numeric_limits<ValueT<SizeSerdes>>::max();
+            return Safe::Add(Safe::Mul(SizeSerdes::Sizeof(), ChunkCount(maxSize) + 1),
+                             Safe::Mul(ElementSerdes::Sizeof(), maxSize));
+        }
+
+        /// @note This function may return WRONG_SIZE if an overflow occurs during computation
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+
+            uint32_t bufSize = Safe::Mul(SizeSerdes::Sizeof(), ChunkCount(static_cast<uint32_t>(size)) + 1);
+
+            if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                return Safe::Add(bufSize, Safe::Mul(static_cast<uint32_t>(size), ElementSerdes::Sizeof()));
+            else
+            {
+                for(const auto &element: range)
+                    bufSize = Safe::Add(bufSize, ElementSerdes::Sizeof(element));
+                return bufSize;
+            }
+        }
+
+        /// @throw std::length_error if the size of the range or of a chunk exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+
+            // Chunk lengths are computed before the elements are written,
+            // so any output iterator can be used
+            auto element = std::ranges::begin(range);
+            for(size_t first = 0; first < size; first += chunkSize)
+            {
+                const size_t count = std::min<size_t>(chunkSize, size - first);
+                uint64_t length = 0;
+
+                if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                    length = static_cast<uint64_t>(count) * ElementSerdes::Sizeof();
+                else
+                    for(size_t i = 0; i < count; i++, ++element)
+                        length += ElementSerdes::Sizeof(*element);
+
+                if(length > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                    utils::Throw<std::length_error>("chunk length exceeds the limit of the size field");
+
+                bufpos = SizeSerdes::SerializeTo(bufpos, length);
+            }
+
+            return details::SerializeTransient<details::CTransientElements<TRange>>(bufpos, [&range](TOutputIterator out)
+            {
+                for(const auto &value: range)
+                    out = ElementSerdes::SerializeTo(out, value);
+                return out;
+            });
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            // The chunk lengths are not needed for serial deserialization
+            bufpos = details::Advance(bufpos, static_cast<uint64_t>(ChunkCount(size)) * SizeSerdes::Sizeof());
+
+            sequence.resize(size);
+            auto element = std::ranges::begin(sequence);
+            for(size_t i = 0; i < size; i++)
+                bufpos = ElementSerdes::DeserializeFrom(bufpos, *element++);
+
+            return bufpos;
+        }
+
+        /// Skips a serialized value using the chunk lengths
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            uint64_t length = 0;
+            for(uint32_t chunk = ChunkCount(size); chunk; chunk--)
+            {
+                ValueT<SizeSerdes> chunkLength{0};
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, chunkLength);
+                length += chunkLength;
+            }
+
+            return details::Advance(bufpos, length);
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        // Stage 1: Count is the number of unread chunk lengths, Param is the sum of the read ones
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                ValueT<SizeSerdes> size{0};
+                if(!cursor.template Read<SizeSerdes>(size))
+                    return false;
+                cursor.Count() = ChunkCount(size);
+                cursor.Stage() = 1;
+            }
+
+            for(; cursor.Count(); cursor.Count()--)
+            {
+                ValueT<SizeSerdes> chunkLength{0};
+                if(!cursor.template Read<SizeSerdes>(chunkLength))
+                    return false;
+                cursor.Param() += chunkLength;
+            }
+
+            const uint64_t length = cursor.Param();
+            cursor.Finish();
+            cursor.Bytes(length);
+            return true;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,368 @@
+#ifndef SERDES_CORE_COMPRESSED_HPP
+#define SERDES_CORE_COMPRESSED_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes wrapper compressing the serialized value
+
+    @details
+        The value is serialized with the inner serdes, and the result is
+        divided into blocks of a fixed size which are compressed independently
+        with the LZ codec (see Lz.hpp). A block that does not shrink is stored
+        as is.
+
+        Serialized data format:
+
+            [raw size][block 1] ... [block k]
+
+            block: [stored size][data]
+
+        where the raw size is the size of the value serialized with the inner
+        serdes and k = ceil(raw size / block size). Both sizes are UInt32; the
+        high bit of the stored size is set for a block stored uncompressed.
+
+        The serializer streams the value: the output of the inner serdes is
+        collected into a buffer of one block, which is compressed and written
+        out as soon as it is full, so the memory used for compression does not
+        depend on the size of the value. The deserializer allocates the buffer
+        for the raw data once, using the raw size, and decompresses the blocks
+        into it.
+
+        Sizeof(value) must be exact, so it compresses the value in the same way,
+        counting the output instead of keeping it, and costs as much as
+        SerializeTo(). Serialize() therefore writes values containing Compressed
+        into a growing buffer without calling Sizeof() (see costlySizeof).
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Skip.hpp"
+#include "Lz.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// @tparam TSerdes Serdes of the value
+    /// @tparam blockSize Size of the blocks the serialized value is divided into (in bytes)
+    template<CSerdes TSerdes, uint32_t blockSize = 64 * 1024>
+    requires (blockSize >= 1024 && blockSize < (uint32_t{1} << 31))
+    struct Compressed
+    {
+        /// Serdes of the value
+        using SerdesType = TSerdes;
+
+        using ValueType = ValueT<SerdesType>;
+
+        using SizeSerdes = Pod<uint32_t>;
+
+        /// Size of the blocks (in bytes)
+        static constexpr uint32_t blockCapacity = blockSize;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{blockSize};
+
+        /// Sizeof(value) compresses the value
+        static constexpr bool costlySizeof = true;
+
+        /// Flag of the stored size marking an uncompressed block
+        static constexpr uint32_t rawBlockFlag = uint32_t{1} << 31;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Compressed; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+            constexpr uint32_t rawSize = SerdesType::Sizeof();
+            return Safe::Add(Safe::Mul(SizeSerdes::Sizeof(), BlockCount(rawSize) + 1), rawSize);
+        }
+
+        /// Compresses the value to determine the size
+        /// @note This function returns WRONG_SIZE if the size of the value exceeds the allowed limit
+        [[nodiscard]] static
+        uint32_t Sizeof(const ValueType &value)
+        {
+            const uint32_t rawSize = SerdesType::Sizeof(value);
+            if(rawSize == WRONG_SIZE)
+                return WRONG_SIZE;
+
+            uint64_t size = SizeSerdes::Sizeof();
+            Compress(value, rawSize, [&size](const uint8_t *, size_t n) { size += n; });
+            return size < WRONG_SIZE ? static_cast<uint32_t>(size) : WRONG_SIZE;
+        }
+
+        /// @throw std::length_error if the size of the value exceeds the allowed limit
+        template<COutputIterator TOutputIterator>
+        static
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const ValueType &value)
+        {
+            const uint32_t rawSize = SerdesType::Sizeof(value);
+            if(rawSize == WRONG_SIZE)
+                utils::Throw<std::length_error>("value size exceeds the allowed limit");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, rawSize);
+
+            // Blocks are written from a buffer reused for the next block, so referencing iterators copy them
+            return details::SerializeTransient(bufpos, [&value, rawSize](TOutputIterator out)
+            {
+                Compress(value, rawSize, [&out](const uint8_t *data, size_t size)
+                {
+                    if constexpr (CBlockOutputIterator<TOutputIterator>)
+                        out = out.WriteBlock(data, size);
+                    else
+                        out = std::copy(data, data + size, out);
+                });
+                return out;
+            });
+        }
+
+        /// @throw std::runtime_error if the compressed data is corrupted
+        template<CInputIterator TInputIterator>
+        static
+        TInputIterator DeserializeFrom(TInputIterator bufpos, ValueType &value)
+        {
+            uint32_t rawSize = 0;
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, rawSize);
+
+            std::vector<uint8_t> raw(rawSize);
+            std::vector<uint8_t> stored;
+
+            for(uint32_t offset = 0; offset < rawSize; offset += blockSize)
+            {
+                const uint32_t size = std::min(blockSize, rawSize - offset);
+
+                uint32_t header = 0;
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, header);
+                const uint32_t storedSize = header & ~rawBlockFlag;
+
+                // Blocks are decoded from the buffer directly when it is contiguous
+                const uint8_t *data;
+                if constexpr (CContiguousByteIterator<TInputIterator>)
+                {
+                    data = reinterpret_cast<const uint8_t *>(std::to_address(bufpos));
+                    bufpos += storedSize;
+                }
+                else
+                {
+                    stored.resize(storedSize);
+                    for(uint8_t &byte: stored)
+                        byte = static_cast<uint8_t>(*bufpos++);
+                    data = stored.data();
+                }
+
+                if(header & rawBlockFlag)
+                {
+                    if(storedSize != size)
+                        utils::Throw<std::runtime_error>("corrupted compressed data: wrong size of a stored block");
+                    std::memcpy(raw.data() + offset, data, size);
+                }
+                else if(!details::Lz::Decompress(data, storedSize, raw.data() + offset, size))
+                    utils::Throw<std::runtime_error>("corrupted compressed data: invalid block");
+            }
+
+            if(SerdesType::DeserializeFrom(raw.cbegin(), value) != raw.cend())
+                utils::Throw<std::runtime_error>("corrupted compressed data: size of the value does not match");
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            uint32_t rawSize = 0;
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, rawSize);
+
+            for(uint32_t blocks = BlockCount(rawSize); blocks; blocks--)
+            {
+                uint32_t header = 0;
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, header);
+                bufpos = details::Advance(bufpos, header & ~rawBlockFlag);
+            }
+
+            return bufpos;
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        // Stage 1: Count is the number of unscanned blocks
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                uint32_t rawSize = 0;
+                if(!cursor.template Read<SizeSerdes>(rawSize))
+                    return false;
+                cursor.Count() = BlockCount(rawSize);
+                cursor.Stage() = 1;
+            }
+
+            if(cursor.Count() == 0)
+            {
+                cursor.Finish();
+                return true;
+            }
+
+            uint32_t header = 0;
+            if(!cursor.template Read<SizeSerdes>(header))
+                return false;
+            cursor.Count()--;
+            cursor.Bytes(header & ~rawBlockFlag);
+            return true;
+        }
+
+        /// Number of blocks for the given raw size
+        [[nodiscard]] static constexpr
+        uint32_t BlockCount(uint32_t rawSize) noexcept { return rawSize / blockSize + (rawSize % blockSize != 0); }
+
+    private:
+        /// Collects the serialized value and passes each block, once it is complete, compressed to a sink
+        template<typename TSink>
+        class BlockWriter
+        {
+        public:
+            /// Output iterator writing to the BlockWriter
+            class Iterator
+            {
+            public:
+                using iterator_category = std::output_iterator_tag;
+                using value_type = void;
+                using difference_type = std::ptrdiff_t;
+                using pointer = void;
+                using reference = void;
+
+                Iterator() = default;
+
+                explicit
+                Iterator(BlockWriter *writer) : _writer(writer) {}
+
+                Iterator &operator=(uint8_t byte)
+                {
+                    _writer->Write(&byte, 1);
+                    return *this;
+                }
+
+                Iterator &operator=(std::byte byte) { return *this = static_cast<uint8_t>(byte); }
+
+                Iterator &operator*() { return *this; }
+                Iterator &operator++() { return *this; }
+                Iterator operator++(int) { return *this; }
+
+                /// Writes a block of bytes
+                Iterator WriteBlock(const uint8_t *data, size_t size)
+                {
+                    _writer->Write(data, size);
+                    return *this;
+                }
+
+            private:
+                BlockWriter *_writer = nullptr;
+            };
+
+            /// @param rawSize Size of the value serialized with the inner serdes
+            BlockWriter(uint32_t rawSize, TSink &sink)
+                : _sink(sink)
+                , _remaining(rawSize)
+                , _raw(std::min(rawSize, blockSize))
+                , _stored(_raw.size())
+            {}
+
+            /// @throw std::logic_error if the inner serdes writes more bytes than its Sizeof() returned
+            void Write(const uint8_t *data, size_t size)
+            {
+                while(size)
+                {
+                    const size_t n = std::min(size, _raw.size() - _pos);
+                    if(n == 0 || n > _remaining - _pos)
+                        utils::Throw<std::logic_error>("serialized value is larger than its size");
+
+                    std::memcpy(_raw.data() + _pos, data, n);
+                    _pos += n;
+                    data += n;
+                    size -= n;
+
+                    if(_pos == std::min<size_t>(_raw.size(), _remaining))
+                        PutBlock();
+                }
+            }
+
+            /// @throw std::logic_error if the inner serdes wrote fewer bytes than its Sizeof() returned
+            void Finish() const
+            {
+                if(_remaining)
+                    utils::Throw<std::logic_error>("serialized value is smaller than its size");
+            }
+
+        private:
+            /// Compresses the collected block; the block is stored as is if compression does not reduce its size
+            void PutBlock()
+            {
+                const uint32_t size = static_cast<uint32_t>(_pos);
+                uint8_t header[SizeSerdes::Sizeof()];
+
+                const size_t storedSize = details::Lz::Compress(_raw.data(), size, _stored.data(), size - 1);
+                if(storedSize == 0)
+                {
+                    SizeSerdes::SerializeTo(header, size | rawBlockFlag);
+                    _sink(header, sizeof(header));
+                    _sink(_raw.data(), size);
+                }
+                else
+                {
+                    SizeSerdes::SerializeTo(header, static_cast<uint32_t>(storedSize));
+                    _sink(header, sizeof(header));
+                    _sink(_stored.data(), storedSize);
+                }
+
+                _remaining -= size;
+                _pos = 0;
+            }
+
+            TSink &_sink;
+
+            /// Number of bytes of the value not yet compressed
+            uint32_t _remaining;
+
+            /// The block being collected
+            std::vector<uint8_t> _raw;
+            size_t _pos = 0;
+
+            /// Compressed data of the block
+            std::vector<uint8_t> _stored;
+        };
+
+        /// Serializes the value and passes the blocks of the compressed data to a sink
+        /// @param sink Callable entity taking a pointer to the data and its size
+        template<typename TSink>
+        static
+        void Compress(const ValueType &value, uint32_t rawSize, TSink &&sink)
+        {
+            BlockWriter<TSink> writer(rawSize, sink);
+            SerdesType::SerializeTo(typename BlockWriter<TSink>::Iterator(&writer), value);
+            writer.Finish();
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -62,6 +62,33 @@ namespace serdes
     concept COutputIterator = std::output_iterator<TIterator, uint8_t>
                               || std::output_iterator<TIterator, std::byte>;
 
+    /// Output iterator that accepts a contiguous block of bytes in a single call
+    // Serdes use WriteBlock(data, size) instead of byte-by-byte output
+    // when the serialized form of a value is its in-memory representation
+    template<typename TIterator>
+    concept CBlockOutputIterator = COutputIterator<TIterator>
+                                   && requires(TIterator bufpos, const uint8_t *data, size_t size)
+                                   {
+                                       { bufpos.WriteBlock(data, size) } -> std::same_as<TIterator>;
+                                   };
+
+    /// Block output iterator that may keep a reference to a written block instead of copying it
+    // (see GatherWriter). Blocks of objects that can be destroyed before the output is consumed
+    // (temporaries, local buffers of serdes) are written through an iterator switched with
+    // CopyBlocks(true), whose WriteBlock copies the data (see details::SerializeTransient)
+    template<typename TIterator>
+    concept CReferencingOutputIterator = CBlockOutputIterator<TIterator>
+                                         && requires(const TIterator bufpos, bool copy)
+                                         {
+                                             { bufpos.CopiesBlocks() } -> std::same_as<bool>;
+                                             { bufpos.CopyBlocks(copy) } -> std::same_as<TIterator>;
+                                         };
+
+    /// Contiguous iterator over single-byte values, usable with memcpy
+    template<typename TIterator>
+    concept CContiguousByteIterator = std::contiguous_iterator<TIterator>
+                                      && sizeof(std::iter_value_t<TIterator>) == 1;
+
     /// Input iterator concept
     // Identical to the standard concept; added for code consistency
     template<typename TIterator>
@@ -26,6 +26,7 @@
 
 */
 //------------------------------------------------------------------------------
+#include <type_traits>
 #include "Concepts.hpp"
 #include "Helpers.hpp"
 
@@ -80,7 +81,12 @@ namespace serdes
         static constexpr
         TOutputIterator SerializeTo(TOutputIterator bufpos, const TValue &ob)
         {
-            return BaseSerdes::SerializeTo(bufpos, ConvToBase(ob));
+            // A base value returned by value is destroyed right after serialization
+            constexpr bool transient = !std::is_reference_v<decltype(ConvToBase(ob))>;
+            return details::SerializeTransient<transient>(bufpos, [&ob](TOutputIterator out)
+            {
+                return BaseSerdes::SerializeTo(out, ConvToBase(ob));
+            });
         }
 
         template<COutputIterator TOutputIterator>
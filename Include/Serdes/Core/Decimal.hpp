@@ -0,0 +1,253 @@
+#ifndef SERDES_CORE_DECIMAL_HPP
+#define SERDES_CORE_DECIMAL_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Fixed-point decimal numbers and their serdes
+
+    @details
+        Prices and quantities are decimal numbers with a fixed number of
+        fractional digits. Converting them through double is inexact and slow;
+        FixedDecimal<scale> stores the number as an integer mantissa equal to
+        the value multiplied by 10^scale, so "50200.05" with scale 2 is stored
+        as 5020005.
+
+        Parse() converts a decimal string exactly in a single pass over the
+        characters, and Format() writes the number with exactly scale
+        fractional digits. Both are constexpr and do not allocate.
+
+            auto price = FixedDecimal<2>::Parse("50200.05");
+            price.ToString(); // "50200.05"
+
+        The Decimal serdes serializes the mantissa with the integer serdes, so
+        the serialized data format is that of the integer serdes. A varint
+        serdes (see Varint.hpp) stores small prices and quantities in fewer
+        bytes:
+
+            using Price = Decimal<2>;             // 8 bytes
+            using Qty = Decimal<8, VarInt64>;     // 1..10 bytes
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <limits>
+#include <string>
+#include <compare>
+#include <concepts>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        template<std::integral T>
+        [[nodiscard]] consteval
+        T Pow10(unsigned exponent)
+        {
+            T value = 1;
+            for(unsigned i = 0; i < exponent; i++)
+                value *= 10;
+            return value;
+        }
+    }
+
+    /// Decimal number with a fixed number of fractional digits
+    /// @tparam scale Number of fractional digits
+    /// @tparam TMantissa Integer type of the mantissa
+    template<unsigned scale, typename TMantissa = int64_t>
+    requires (std::integral<TMantissa> && !std::same_as<TMantissa, bool>
+              && scale <= std::numeric_limits<TMantissa>::digits10)
+    struct FixedDecimal
+    {
+        using MantissaType = TMantissa;
+
+        /// Number of fractional digits
+        static constexpr unsigned decimalScale = scale;
+
+        /// Mantissa of the number 1
+        static constexpr MantissaType one = details::Pow10<MantissaType>(scale);
+
+        /// Maximum length of the formatted number
+        static constexpr size_t maxLength = std::numeric_limits<MantissaType>::digits10 + 4;
+
+        /// Value multiplied by 10^scale
+        MantissaType mantissa = 0;
+
+        [[nodiscard]] static constexpr
+        FixedDecimal FromMantissa(MantissaType mantissa) noexcept { return FixedDecimal{mantissa}; }
+
+        /// Parses a decimal number: an optional sign, digits and an optional
+        /// fractional part; extra fractional digits are allowed only if they are zeros
+        /// @return false if the text is not a number or the number cannot be represented exactly
+        [[nodiscard]] static constexpr
+        bool TryParse(std::string_view text, FixedDecimal &number) noexcept
+        {
+            using Unsigned = std::make_unsigned_t<MantissaType>;
+
+            size_t pos = 0;
+            const bool negative = pos < text.size() && text[pos] == '-';
+            if(pos < text.size() && (text[pos] == '-' || text[pos] == '+'))
+                pos++;
+            if constexpr (std::is_unsigned_v<MantissaType>)
+                if(negative)
+                    return false;
+
+            // The magnitude is accumulated as unsigned, so the minimum value of a signed type is parsed
+            const Unsigned limit = static_cast<Unsigned>(std::numeric_limits<MantissaType>::max()) + negative;
+            Unsigned magnitude = 0;
+            size_t digits = 0;
+
+            const auto append = [&](char c)
+            {
+                const auto digit = static_cast<unsigned>(c - '0');
+                if(magnitude > (limit - digit) / 10)
+                    return false;
+                magnitude = magnitude * 10 + digit;
+                return true;
+            };
+
+            for(; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; pos++, digits++)
+                if(!append(text[pos]))
+                    return false;
+
+            unsigned fractionDigits = 0;
+            if(pos < text.size() && text[pos] == '.')
+            {
+                for(pos++; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; pos++, digits++)
+                    if(fractionDigits < scale)
+                    {
+                        if(!append(text[pos]))
+                            return false;
+                        fractionDigits++;
+                    }
+                    else if(text[pos] != '0')
+                        return false;
+            }
+
+            if(pos != text.size() || digits == 0)
+                return false;
+
+            for(; fractionDigits < scale; fractionDigits++)
+                if(!append('0'))
+                    return false;
+
+            number.mantissa = static_cast<MantissaType>(negative ? Unsigned{0} - magnitude : magnitude);
+            return true;
+        }
+
+        /// @throw std::invalid_argument if the text is not a number or the number cannot be represented exactly
+        [[nodiscard]] static constexpr
+        FixedDecimal Parse(std::string_view text)
+        {
+            FixedDecimal number;
+            if(!TryParse(text, number))
+                utils::Throw<std::invalid_argument>("invalid decimal number");
+            return number;
+        }
+
+        /// Writes the number with scale fractional digits (at most maxLength characters)
+        /// @return Pointer to the character following the last written one
+        constexpr
+        char *Format(char *first) const noexcept
+        {
+            using Unsigned = std::make_unsigned_t<MantissaType>;
+
+            Unsigned magnitude = static_cast<Unsigned>(mantissa);
+            if constexpr (std::is_signed_v<MantissaType>)
+                if(mantissa < 0)
+                {
+                    *first++ = '-';
+                    magnitude = Unsigned{0} - magnitude;
+                }
+
+            // Digits are written from the end into a local buffer
+            char digits[maxLength];
+            char *const end = digits + maxLength;
+            char *p = end;
+
+            for(unsigned i = 0; i < scale; i++, magnitude /= 10)
+                *--p = static_cast<char>('0' + magnitude % 10);
+            if constexpr (scale != 0)
+                *--p = '.';
+            do
+                *--p = static_cast<char>('0' + magnitude % 10);
+            while(magnitude /= 10);
+
+            while(p != end)
+                *first++ = *p++;
+            return first;
+        }
+
+        [[nodiscard]] constexpr
+        std::string ToString() const
+        {
+            char buffer[maxLength];
+            return std::string(buffer, Format(buffer));
+        }
+
+        /// @note The conversion is inexact for mantissas exceeding 2^53
+        [[nodiscard]] constexpr
+        double ToDouble() const noexcept { return static_cast<double>(mantissa) / static_cast<double>(one); }
+
+        friend constexpr auto operator<=>(const FixedDecimal &, const FixedDecimal &) = default;
+    };
+
+    //--------------------------------------------------------------------------
+    /// @tparam scale Number of fractional digits
+    /// @tparam TIntSerdes Serdes of the mantissa (Pod or Varint serdes for an integer)
+    template<unsigned scale, CSerdes TIntSerdes = Pod<int64_t, PodTypeId::Int64>>
+    requires std::integral<ValueT<TIntSerdes>>
+    struct Decimal
+    {
+        /// Serdes of the mantissa
+        using SerdesType = TIntSerdes;
+
+        using ValueType = FixedDecimal<scale, ValueT<SerdesType>>;
+
+        /// Number of fractional digits
+        static constexpr unsigned decimalScale = scale;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{scale};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Decimal; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return SerdesType::GetBufferType(); }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof() { return SerdesType::Sizeof(); }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const ValueType &value) { return SerdesType::Sizeof(value.mantissa); }
+
+        template<COutputIterator TOutputIterator>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const ValueType &value)
+        {
+            return SerdesType::SerializeTo(bufpos, value.mantissa);
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, ValueType &value)
+        {
+            return SerdesType::DeserializeFrom(bufpos, value.mantissa);
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
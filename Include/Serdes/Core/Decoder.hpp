@@ -0,0 +1,674 @@
+#ifndef SERDES_CORE_DECODER_HPP
+#define SERDES_CORE_DECODER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Resumable incremental decoder for values received in fragments
+
+    @details
+        IncrementalDecoder accumulates the bytes of a serialized value as they
+        arrive (for example, from a non-blocking socket) and tracks the structure
+        of the value incrementally: range sizes, variant indices, pointer flags and
+        positions inside nested tuples are kept between calls, so a received byte
+        is usually examined only once. After each chunk the decoder reports either
+        the minimum number of bytes still needed before it can make progress
+        (DecodeState::NeedMore) or completion of the value (DecodeState::Done).
+
+        Data can be received directly into the decoder buffer, avoiding an
+        intermediate copy:
+
+            IncrementalDecoder<Message> decoder;
+            auto status = decoder.Status();
+            while(!status.IsDone())
+            {
+                auto space = decoder.Prepare(std::max<size_t>(status.needed, 4096));
+                const ssize_t received = recv(fd, space.data(), space.size(), 0);
+                if(received <= 0)
+                    break; // error or end of stream
+                status = decoder.Commit(static_cast<size_t>(received));
+            }
+            auto message = decoder.Value();
+            decoder.Next(); // bytes following the value are kept for the next one
+
+        Supported are all serdes whose layout is known to Skip (see Skip.hpp).
+        A serdes with its own data format makes its values resumable by providing
+        a static member function template
+
+            template<typename TCursor>
+            static constexpr bool Scan(TCursor &cursor);
+
+        The decoder calls it whenever its frame is on top of the scan stack. The
+        function reads the input through the cursor (Read, ReadVarint, Need,
+        Data/Consume), keeps its progress in the registers of the frame (Count,
+        Stage, Param; zero initially) and schedules nested parts of the value:
+        Then<TSerdes>(count) for values of other serdes, Bytes(n) and Varints(n)
+        for runs of opaque bytes and LEB128 integers. Scheduled parts are scanned
+        in the order of the calls before the function is called again; Finish()
+        completes the value, parts scheduled after it follow the value. The
+        function returns false if the input runs out (the reading functions report
+        the missing bytes) and true after any progress.
+
+        Serdes that define only a Skip function are scanned by calling Skip on the
+        buffered bytes of the value; if the bytes run out, the value of such a
+        serdes is scanned again from its beginning when more data arrives, so
+        their cost grows with the number of fragments.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <span>
+#include <array>
+#include <tuple>
+#include <vector>
+#include <compare>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Skip.hpp"
+#include "Varint.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// State of incremental decoding
+    enum class DecodeState : uint8_t
+    {
+        NeedMore, // more input is required
+        Done      // the value is complete
+    };
+
+    /// Result of incremental decoding
+    struct DecodeStatus
+    {
+        DecodeState state;
+
+        /// Minimum number of bytes required before decoding can make progress (0 when Done)
+        size_t needed;
+
+        [[nodiscard]] constexpr
+        bool IsDone() const noexcept { return state == DecodeState::Done; }
+    };
+
+    namespace details
+    {
+        struct ScanState;
+
+        /// Step function of a frame; returns false if more input is required
+        using ScanStep = bool (*)(ScanState &state, size_t frame);
+
+        /// Position inside a serialized value of a particular serdes
+        struct ScanFrame
+        {
+            ScanStep step;
+
+            /// Remaining bytes, elements, or the index of the next tuple element
+            uint64_t remaining;
+
+            /// Registers of a scan hook
+            uint64_t stage = 0;
+            uint64_t param = 0;
+        };
+
+        /// Scanning state: stack of frames and unscanned input
+        struct ScanState
+        {
+            std::vector<ScanFrame> stack;
+            const uint8_t *data = nullptr;
+            size_t avail = 0;
+            size_t needed = 0;
+
+            void Consume(size_t n) noexcept
+            {
+                data += n;
+                avail -= n;
+            }
+        };
+
+        /// Access of a scan hook to the input and to its frame (see the description of the file)
+        class ScanCursor
+        {
+        public:
+            ScanCursor(ScanState &state, size_t frame) noexcept : _state(state), _frame(frame), _insert(frame + 1) {}
+
+            /// Unscanned input
+            [[nodiscard]]
+            const uint8_t *Data() const noexcept { return _state.data; }
+
+            /// Number of bytes of unscanned input
+            [[nodiscard]]
+            size_t Available() const noexcept { return _state.avail; }
+
+            /// Marks n available bytes as scanned
+            void Consume(size_t n) noexcept { _state.Consume(n); }
+
+            /// Checks that n bytes are available, otherwise reports the missing bytes
+            [[nodiscard]]
+            bool Need(size_t n) noexcept
+            {
+                if(_state.avail >= n)
+                    return true;
+                _state.needed = n - _state.avail;
+                return false;
+            }
+
+            /// Reads a value of a serdes with a static buffer
+            /// @return false if the input runs out
+            template<CSerdes TSerdes>
+            requires (TSerdes::GetBufferType() == BufferType::Static)
+            [[nodiscard]]
+            bool Read(ValueT<TSerdes> &value)
+            {
+                if(!Need(TSerdes::Sizeof()))
+                    return false;
+                TSerdes::DeserializeFrom(_state.data, value);
+                _state.Consume(TSerdes::Sizeof());
+                return true;
+            }
+
+            /// Reads a LEB128 integer
+            /// @return false if the input runs out
+            [[nodiscard]]
+            bool ReadVarint(uint64_t &value)
+            {
+                const auto end = _state.data + _state.avail;
+                if(std::find_if(_state.data, end, [](uint8_t byte) { return byte < 0x80; }) == end)
+                {
+                    _state.needed = 1;
+                    return false;
+                }
+                const uint8_t *next = DeserializeVarint(_state.data, value);
+                _state.Consume(static_cast<size_t>(next - _state.data));
+                return true;
+            }
+
+            /// Registers of the frame (invalid after Finish)
+            [[nodiscard]]
+            uint64_t &Count() noexcept { return _state.stack[_frame].remaining; }
+
+            [[nodiscard]]
+            uint64_t &Stage() noexcept { return _state.stack[_frame].stage; }
+
+            [[nodiscard]]
+            uint64_t &Param() noexcept { return _state.stack[_frame].param; }
+
+            /// Schedules count values of the serdes
+            template<CSerdes TSerdes>
+            void Then(uint64_t count = 1);
+
+            /// Schedules n bytes
+            void Bytes(uint64_t n);
+
+            /// Schedules n LEB128 integers
+            void Varints(uint64_t n);
+
+            /// Completes the value of the hook
+            void Finish()
+            {
+                _state.stack.erase(_state.stack.begin() + static_cast<std::ptrdiff_t>(_frame));
+                _insert--;
+            }
+
+        private:
+            // Frames are inserted below the ones scheduled earlier, so that they are scanned in the order of the calls
+            void Schedule(const ScanFrame &frame)
+            {
+                _state.stack.insert(_state.stack.begin() + static_cast<std::ptrdiff_t>(_insert), frame);
+            }
+
+            ScanState &_state;
+            size_t _frame;
+            size_t _insert;
+        };
+
+        /// Serdes with a resumable scan function
+        template<typename TSerdes>
+        concept CScannable = requires(ScanCursor &cursor)
+        {
+            { TSerdes::Scan(cursor) } -> std::same_as<bool>;
+        };
+
+        /// Thrown by ScanIterator when the input runs out
+        struct ScanUnderflow
+        {
+            /// Minimum number of missing bytes
+            size_t needed;
+        };
+
+        /// Iterator over the unscanned input used to probe serdes with their own Skip function
+        // Reading past the input throws ScanUnderflow; advancing past it is detected by the caller
+        class ScanIterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = uint8_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const uint8_t *;
+            using reference = const uint8_t &;
+
+            ScanIterator() = default;
+
+            ScanIterator(const uint8_t *data, size_t avail, size_t pos = 0) noexcept
+                : _data(data), _avail(avail), _pos(pos) {}
+
+            reference operator*() const
+            {
+                if(_pos >= _avail)
+                    throw ScanUnderflow{_pos - _avail + 1};
+                return _data[_pos];
+            }
+
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            ScanIterator &operator++() noexcept { _pos++; return *this; }
+            ScanIterator operator++(int) noexcept { auto it = *this; _pos++; return it; }
+            ScanIterator &operator--() noexcept { _pos--; return *this; }
+            ScanIterator operator--(int) noexcept { auto it = *this; _pos--; return it; }
+
+            ScanIterator &operator+=(difference_type n) noexcept { _pos += static_cast<size_t>(n); return *this; }
+            ScanIterator &operator-=(difference_type n) noexcept { _pos -= static_cast<size_t>(n); return *this; }
+
+            friend ScanIterator operator+(ScanIterator it, difference_type n) noexcept { return it += n; }
+            friend ScanIterator operator+(difference_type n, ScanIterator it) noexcept { return it += n; }
+            friend ScanIterator operator-(ScanIterator it, difference_type n) noexcept { return it -= n; }
+
+            friend difference_type operator-(const ScanIterator &a, const ScanIterator &b) noexcept
+            {
+                return static_cast<difference_type>(a._pos) - static_cast<difference_type>(b._pos);
+            }
+
+            friend bool operator==(const ScanIterator &a, const ScanIterator &b) noexcept { return a._pos == b._pos; }
+            friend auto operator<=>(const ScanIterator &a, const ScanIterator &b) noexcept { return a._pos <=> b._pos; }
+
+            /// Number of bytes from the beginning of the input
+            [[nodiscard]]
+            size_t Position() const noexcept { return _pos; }
+
+        private:
+            const uint8_t *_data = nullptr;
+            size_t _avail = 0;
+            size_t _pos = 0;
+        };
+
+        /// Step functions generated for serdes types
+        struct Scan
+        {
+            /// Creates the initial frame for a value of the serdes
+            template<CSerdes TSerdes>
+            static constexpr
+            ScanFrame Start()
+            {
+                if constexpr (CScannable<TSerdes>)
+                    return {&Hook<TSerdes>, 0};
+
+                else if constexpr (CSkippable<TSerdes, const uint8_t *>)
+                    return {&Probe<TSerdes>, 0};
+
+                else if constexpr (TSerdes::GetBufferType() == BufferType::Static)
+                    return {&Bytes, TSerdes::Sizeof()};
+
+                else if constexpr (CBasedSerdes<TSerdes>)
+                    return Start<typename TSerdes::BaseSerdes>();
+
+                else if constexpr (CListSerdes<TSerdes> && TSerdes::GetTypeId() == TypeId::Variant)
+                    return {&Variant<typename TSerdes::SerdesList>, 0};
+
+                else if constexpr (CListSerdes<TSerdes> && TSerdes::GetTypeId() == TypeId::Tuple)
+                    return {&Tuple<typename TSerdes::SerdesList>, 0};
+
+                else if constexpr (CRangeSerdes<TSerdes>)
+                    return {&Range<TSerdes>, 0};
+
+                else if constexpr (CArraySerdes<TSerdes>)
+                    return {&Elements<typename TSerdes::ElementSerdes>, TSerdes::arraySize};
+
+                else if constexpr (CIndirectSerdes<TSerdes>)
+                    return Start<typename TSerdes::SerdesType>();
+
+                else
+                    static_assert(dependentFalse<TSerdes>, "IncrementalDecoder: the serdes layout is unknown");
+            }
+
+            /// Serdes with a scan hook
+            template<CSerdes TSerdes>
+            static
+            bool Hook(ScanState &state, size_t frame)
+            {
+                ScanCursor cursor(state, frame);
+                return TSerdes::Scan(cursor);
+            }
+
+            /// Serdes with its own Skip function: the whole value is skipped in the available
+            /// input; if the input runs out, the value is probed again when more data arrives
+            template<CSerdes TSerdes>
+            static
+            bool Probe(ScanState &state, size_t)
+            {
+                size_t size;
+                try
+                {
+                    size = TSerdes::Skip(ScanIterator(state.data, state.avail)).Position();
+                }
+                catch(const ScanUnderflow &underflow)
+                {
+                    state.needed = underflow.needed;
+                    return false;
+                }
+
+                // The value may end past the input without reading its last bytes
+                if(size > state.avail)
+                {
+                    state.needed = size - state.avail;
+                    return false;
+                }
+
+                state.Consume(size);
+                state.stack.pop_back();
+                return true;
+            }
+
+            /// Fixed number of bytes
+            static
+            bool Bytes(ScanState &state, size_t frame)
+            {
+                ScanFrame &f = state.stack[frame];
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(state.avail, f.remaining));
+                state.Consume(n);
+                f.remaining -= n;
+
+                if(f.remaining)
+                {
+                    state.needed = static_cast<size_t>(f.remaining);
+                    return false;
+                }
+
+                state.stack.pop_back();
+                return true;
+            }
+
+            /// Sequence of LEB128 integers: the remaining count is decremented at every last byte
+            static
+            bool Varints(ScanState &state, size_t frame)
+            {
+                ScanFrame &f = state.stack[frame];
+                size_t n = 0;
+                for(; n < state.avail && f.remaining; n++)
+                    f.remaining -= state.data[n] < 0x80;
+                state.Consume(n);
+
+                if(f.remaining)
+                {
+                    state.needed = static_cast<size_t>(std::min<uint64_t>(f.remaining, SIZE_MAX));
+                    return false;
+                }
+
+                state.stack.pop_back();
+                return true;
+            }
+
+            /// Sequence of elements with a dynamic buffer
+            template<CSerdes TElementSerdes>
+            static
+            bool Elements(ScanState &state, size_t frame)
+            {
+                ScanFrame &f = state.stack[frame];
+                if(f.remaining == 0)
+                    state.stack.pop_back();
+                else
+                {
+                    f.remaining--;
+                    state.stack.push_back(Start<TElementSerdes>());
+                }
+                return true;
+            }
+
+            /// Range: the size field followed by the elements
+            template<CSerdes TSerdes>
+            static
+            bool Range(ScanState &state, size_t frame)
+            {
+                using SizeSerdes = typename TSerdes::SizeSerdes;
+                using ElementSerdes = typename TSerdes::ElementSerdes;
+
+                constexpr size_t sizelen = SizeSerdes::Sizeof();
+                if(state.avail < sizelen)
+                {
+                    state.needed = sizelen - state.avail;
+                    return false;
+                }
+
+                ValueT<SizeSerdes> size{0};
+                SizeSerdes::DeserializeFrom(state.data, size);
+                state.Consume(sizelen);
+
+                if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                    state.stack[frame] = {&Bytes, static_cast<uint64_t>(size) * ElementSerdes::Sizeof()};
+                else
+                    state.stack[frame] = {&Elements<ElementSerdes>, static_cast<uint64_t>(size)};
+
+                return true;
+            }
+
+            /// Tuple: elements in order
+            template<typename TSerdesList>
+            static
+            bool Tuple(ScanState &state, size_t frame)
+            {
+                constexpr auto starts = []<typename ...TSerdes>(std::tuple<TSerdes...> *)
+                {
+                    return std::array<ScanFrame (*)(), sizeof...(TSerdes)>{&Start<TSerdes>...};
+                }(static_cast<TSerdesList *>(nullptr));
+
+                ScanFrame &f = state.stack[frame];
+                if(f.remaining == starts.size())
+                    state.stack.pop_back();
+                else
+                    state.stack.push_back(starts[f.remaining++]());
+                return true;
+            }
+
+            /// Variant and Pointer: the index followed by the alternative
+            template<typename TSerdesList>
+            static
+            bool Variant(ScanState &state, size_t frame)
+            {
+                constexpr auto starts = []<typename ...TSerdes>(std::tuple<TSerdes...> *)
+                {
+                    return std::array<ScanFrame (*)(), sizeof...(TSerdes)>{&Start<TSerdes>...};
+                }(static_cast<TSerdesList *>(nullptr));
+
+                if(state.avail < 1)
+                {
+                    state.needed = 1;
+                    return false;
+                }
+
+                const uint8_t index = *state.data;
+                if(index >= starts.size())
+                    utils::Throw<std::runtime_error>(std::format("invalid variant index {}", index));
+                state.Consume(1);
+
+                state.stack[frame] = starts[index]();
+                return true;
+            }
+        };
+
+        template<CSerdes TSerdes>
+        void ScanCursor::Then(uint64_t count)
+        {
+            if constexpr (TSerdes::GetBufferType() == BufferType::Static)
+                Bytes(count * TSerdes::Sizeof());
+            else if(count == 1)
+                Schedule(Scan::Start<TSerdes>());
+            else if(count)
+                Schedule({&Scan::Elements<TSerdes>, count});
+        }
+
+        inline
+        void ScanCursor::Bytes(uint64_t n)
+        {
+            if(n)
+                Schedule({&Scan::Bytes, n});
+        }
+
+        inline
+        void ScanCursor::Varints(uint64_t n)
+        {
+            if(n)
+                Schedule({&Scan::Varints, n});
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Resumable decoder of a single value
+    /// @tparam TSerdes Pack of serdes used to serialize the value
+    template<CSerdes ...TSerdes>
+    class IncrementalDecoder
+    {
+    public:
+        using Serdes = SerdesT<TSerdes...>;
+
+        IncrementalDecoder()
+        {
+            Restart();
+            Advance();
+        }
+
+        /// Returns writable space for at least n bytes at the end of the buffer
+        /// @note The space must be committed with Commit() before the next call to Prepare().
+        [[nodiscard]]
+        std::span<uint8_t> Prepare(size_t n)
+        {
+            if(_buffer.size() < _size + n)
+                _buffer.resize(std::max(_size + n, _buffer.size() * 2));
+            return {_buffer.data() + _size, _buffer.size() - _size};
+        }
+
+        /// Commits n bytes written to the space returned by Prepare() and continues decoding
+        /// @throw std::length_error if n exceeds the prepared space
+        DecodeStatus Commit(size_t n)
+        {
+            // A negative result of recv() converted to size_t is caught here
+            if(n > _buffer.size() - _size)
+                utils::Throw<std::length_error>("committed size exceeds the prepared space");
+            _size += n;
+            return Advance();
+        }
+
+        /// Appends a chunk of data and continues decoding
+        DecodeStatus Feed(std::span<const uint8_t> chunk)
+        {
+            auto space = Prepare(chunk.size());
+            std::copy(chunk.begin(), chunk.end(), space.begin());
+            return Commit(chunk.size());
+        }
+
+        /// Current decoding status
+        [[nodiscard]]
+        DecodeStatus Status() const noexcept { return _status; }
+
+        /// Size of the serialized value (meaningful when the value is complete)
+        [[nodiscard]]
+        size_t Size() const noexcept { return _scanned; }
+
+        /// Serialized value
+        [[nodiscard]]
+        std::span<const uint8_t> Data() const noexcept { return {_buffer.data(), _scanned}; }
+
+        /// Deserializes the complete value
+        /// @throw std::logic_error if the value is not complete
+        template<typename ...TValues>
+        void DeserializeTo(TValues &...values) const
+        {
+            CheckDone();
+            Serdes::DeserializeFrom(static_cast<const uint8_t *>(_buffer.data()), values...);
+        }
+
+        /// Deserializes the complete value with automatic value construction
+        /// @throw std::logic_error if the value is not complete
+        [[nodiscard]]
+        ValueT<Serdes> Value() const
+        {
+            ValueT<Serdes> value;
+            DeserializeTo(value);
+            return value;
+        }
+
+        /// Discards the decoded value and starts decoding the next one from the remaining bytes
+        DecodeStatus Next()
+        {
+            CheckDone();
+            std::memmove(_buffer.data(), _buffer.data() + _scanned, _size - _scanned);
+            _size -= _scanned;
+            Restart();
+            return Advance();
+        }
+
+        /// Discards all data and restarts decoding
+        void Reset()
+        {
+            _size = 0;
+            Restart();
+            Advance();
+        }
+
+    private:
+        void Restart()
+        {
+            _scanned = 0;
+            _state.stack.clear();
+            _state.stack.push_back(details::Scan::Start<Serdes>());
+            _status = {DecodeState::NeedMore, 0};
+        }
+
+        void CheckDone() const
+        {
+            if(!_status.IsDone())
+                utils::Throw<std::logic_error>("the value is not complete");
+        }
+
+        /// Scans the bytes received since the previous call
+        DecodeStatus Advance()
+        {
+            _state.data = _buffer.data() + _scanned;
+            _state.avail = _size - _scanned;
+
+            while(!_state.stack.empty())
+            {
+                const size_t frame = _state.stack.size() - 1;
+                if(!_state.stack[frame].step(_state, frame))
+                    break;
+            }
+
+            _scanned = static_cast<size_t>(_state.data - _buffer.data());
+
+            _status = _state.stack.empty() ? DecodeStatus{DecodeState::Done, 0}
+                                           : DecodeStatus{DecodeState::NeedMore, _state.needed};
+            return _status;
+        }
+
+        /// Received data
+        std::vector<uint8_t> _buffer;
+
+        /// Number of received bytes
+        size_t _size = 0;
+
+        /// Number of scanned bytes
+        size_t _scanned = 0;
+
+        details::ScanState _state;
+        DecodeStatus _status{DecodeState::NeedMore, 0};
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -23,6 +23,7 @@
 
 //------------------------------------------------------------------------------
 #include <limits>
+#include <bitset>
 #include <type_traits>
 #include "Typedefs.hpp"
 
@@ -172,11 +173,20 @@ namespace serdes
     template<typename T, std::size_t N>
     struct Default<T[N]> { using Type = Array<DefaultT<T>, N>; };
 
+    template<std::size_t N>
+    struct Default<std::bitset<N>> { using Type = BitArray<N>; };
+
+    template<unsigned scale, typename TMantissa>
+    struct Default<FixedDecimal<scale, TMantissa>> { using Type = Decimal<scale, DefaultT<TMantissa>>; };
+
 
     /// Dynamic containers
     template<typename T, typename TAlloc>
     struct Default<std::vector<T, TAlloc>> { using Type = Vector<DefaultT<T>, TAlloc>; };
 
+    template<typename TAlloc>
+    struct Default<std::vector<bool, TAlloc>> { using Type = BitVector<TAlloc>; };
+
     template<typename T, typename TAlloc>
     struct Default<std::deque<T, TAlloc>> { using Type = Deque<DefaultT<T>, TAlloc>; };
 
@@ -0,0 +1,271 @@
+#ifndef SERDES_CORE_DELTA_HPP
+#define SERDES_CORE_DELTA_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for sequences of integers and timestamps with delta encoding
+
+    @details
+        Monotonic ids and timestamps differ little from their neighbours, so
+        instead of the elements the serdes stores the first element and then
+        the differences between consecutive elements (order 1) or the
+        differences between consecutive differences (order 2, "delta of
+        delta", suitable for timestamps taken at a nearly constant rate) as
+        zigzag varints (see Varint.hpp).
+
+        Serialized data format:
+
+            [n][first element][d(1)] ... [d(n-1)]
+
+        where n is serialized with the size serdes, the first element with the
+        element serdes and
+
+            order 1: d(i) = x(i) - x(i-1)
+            order 2: d(1) = x(1) - x(0), d(i) = x(i) - 2 * x(i-1) + x(i-2)
+
+        Differences are computed modulo 2^64, so any integer sequence can be
+        serialized, but only sequences with small differences are compressed.
+
+        The deserializer restores the elements with running sums (two for
+        order 2) while decoding the differences, writing each element directly
+        into the sequence without an intermediate buffer. Decoding of varints
+        is sequential, so the sums are accumulated in the same pass rather than
+        in a separate prefix sum pass.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <ranges>
+#include <limits>
+#include <iterator>
+#include <concepts>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Varint.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Integer or duration (for example, DateTime) value with at most 64 bits
+        template<typename T>
+        concept CDeltaValue = (std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 8)
+                              || requires(const T &value)
+                              {
+                                  { value.count() } -> std::integral;
+                                  requires sizeof(typename T::rep) <= 8;
+                              };
+
+        /// Converts a value to an integer for computing differences modulo 2^64
+        template<CDeltaValue T>
+        [[nodiscard]] constexpr
+        uint64_t ToDeltaInteger(const T &value) noexcept
+        {
+            if constexpr (std::integral<T>)
+                return static_cast<uint64_t>(value);
+            else
+                return static_cast<uint64_t>(value.count());
+        }
+
+        template<CDeltaValue T>
+        [[nodiscard]] constexpr
+        T FromDeltaInteger(uint64_t value) noexcept
+        {
+            if constexpr (std::integral<T>)
+                return static_cast<T>(value);
+            else
+                return T(static_cast<typename T::rep>(value));
+        }
+    }
+
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements
+    /// @tparam TElementSerdes Serdes of the first element; must be a POD serdes for an integer or a duration
+    /// @tparam TValueType Sequential container type
+    /// @tparam order 1 - differences between elements, 2 - differences between differences
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType,
+        uint8_t order = 1>
+    requires (TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+             && (TElementSerdes::GetTypeId() == TypeId::Pod)
+             && details::CDeltaValue<ValueT<TElementSerdes>>
+             && (order == 1 || order == 2)
+    struct Delta
+    {
+        /// Serdes for serializing/deserializing the number of elements
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing the first element
+        using ElementSerdes = TElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = TValueType;
+
+        /// Order of the differences
+        static constexpr uint8_t deltaOrder = order;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{order};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Delta; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+            constexpr uint32_t maxSize = std::numeric_limits<ValueT<SizeSerdes>>::max();
+            return Safe::Add(Safe::Add(SizeSerdes::Sizeof(), ElementSerdes::Sizeof()),
+                             Safe::Mul(maxSize - 1, Varint<uint64_t>::Sizeof()));
+        }
+
+        /// @note This function may return WRONG_SIZE if an overflow occurs during computation
+        /// or if the range size exceeds the maximum allowed value
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+            if(size == 0)
+                return SizeSerdes::Sizeof();
+
+            uint64_t bufSize = SizeSerdes::Sizeof() + ElementSerdes::Sizeof();
+            ForEachDelta(range, [&bufSize](uint64_t delta) { bufSize += details::VarintSize(delta); });
+
+            return bufSize < WRONG_SIZE ? static_cast<uint32_t>(bufSize) : WRONG_SIZE;
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+            if(size == 0)
+                return bufpos;
+
+            bufpos = ElementSerdes::SerializeTo(bufpos, *std::ranges::begin(range));
+            ForEachDelta(range, [&bufpos](uint64_t delta) { bufpos = details::SerializeVarint(bufpos, delta); });
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            sequence.resize(size);
+            if(size == 0)
+                return bufpos;
+
+            ElementType first{};
+            bufpos = ElementSerdes::DeserializeFrom(bufpos, first);
+
+            auto element = std::ranges::begin(sequence);
+            *element = first;
+
+            // Running sums of the differences (of the second differences for order 2)
+            uint64_t value = details::ToDeltaInteger(first);
+            uint64_t delta = 0;
+            for(size_t i = 1; i < size; i++)
+            {
+                uint64_t encoded = 0;
+                bufpos = details::DeserializeVarint(bufpos, encoded);
+
+                if constexpr (order == 2)
+                    value += delta += static_cast<uint64_t>(details::ZigZagDecode(encoded));
+                else
+                    value += static_cast<uint64_t>(details::ZigZagDecode(encoded));
+
+                *++element = details::FromDeltaInteger<ElementType>(value);
+            }
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            if(size == 0)
+                return bufpos;
+
+            bufpos = details::Advance(bufpos, ElementSerdes::Sizeof());
+            for(uint32_t i = 1; i < size; i++)
+                bufpos = details::SkipVarint(bufpos);
+
+            return bufpos;
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            ValueT<SizeSerdes> size{0};
+            if(!cursor.template Read<SizeSerdes>(size))
+                return false;
+
+            cursor.Finish();
+            if(size)
+            {
+                cursor.Bytes(ElementSerdes::Sizeof());
+                cursor.Varints(size - 1);
+            }
+            return true;
+        }
+
+    private:
+        /// Calls the function with the zigzag-encoded differences of a nonempty range
+        template<std::ranges::forward_range TRange, typename TFunction>
+        static constexpr
+        void ForEachDelta(const TRange &range, TFunction &&function)
+        {
+            auto it = std::ranges::begin(range);
+            uint64_t previous = details::ToDeltaInteger(static_cast<ElementType>(*it));
+            uint64_t previousDelta = 0;
+
+            for(++it; it != std::ranges::end(range); ++it)
+            {
+                const uint64_t current = details::ToDeltaInteger(static_cast<ElementType>(*it));
+                const uint64_t delta = current - previous;
+
+                if constexpr (order == 1)
+                    function(details::ZigZagEncode(static_cast<int64_t>(delta)));
+                else
+                    function(details::ZigZagEncode(static_cast<int64_t>(delta - previousDelta)));
+
+                previous = current;
+                previousDelta = delta;
+            }
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,375 @@
+#ifndef SERDES_CORE_DICT_HPP
+#define SERDES_CORE_DICT_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for sequences with dictionary encoding
+
+    @details
+        Columns of low cardinality (exchange codes, currencies, order sides)
+        repeat a small number of distinct values. The serdes stores every
+        distinct value once, in the order of first occurrence, and replaces
+        the elements with their indices in this dictionary (codes).
+
+        Serialized data format:
+
+            [n][d][value 1] ... [value d][code width][code 1] ... [code n]
+
+        where n and d are serialized with the size serdes and the values with
+        the element serdes. The code width (UInt8) is 1 for d <= 256, 2 for
+        d <= 65536 (codes are UInt8 and UInt16) and 0 for larger dictionaries,
+        whose codes are unsigned varints (see Varint.hpp).
+
+        The deserializer decodes each distinct value once and copies it into
+        the elements, so elements of other types (std::string included) own
+        separate copies of the values. Only string views share them: if the
+        elements of the target container are string views (the buffer must be
+        contiguous), no strings are created and the views refer to the
+        dictionary in the buffer, which must outlive them.
+
+            std::vector<std::string_view> sides;
+            DeserializeFrom<DictVector<String>>(buf.data(), sides);
+
+        The elements of serialized ranges are looked up in a hash table, so
+        their type (or the string view type for strings) must have a
+        std::hash specialization and operator==.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <limits>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <concepts>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Varint.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// String type whose values can be looked up by a string view without copying
+        template<typename T>
+        concept CViewableString = requires
+        {
+            typename T::value_type;
+            typename T::traits_type;
+        } && std::convertible_to<const T &, std::basic_string_view<typename T::value_type, typename T::traits_type>>;
+
+        template<typename T>
+        struct DictKey { using Type = T; };
+
+        template<CViewableString T>
+        struct DictKey<T> { using Type = std::basic_string_view<typename T::value_type, typename T::traits_type>; };
+
+        /// Element type whose dictionary key can be hashed and compared
+        template<typename T>
+        concept CHashableDictKey = std::equality_comparable<typename DictKey<T>::Type>
+                                   && requires(const typename DictKey<T>::Type &key)
+        {
+            { std::hash<typename DictKey<T>::Type>{}(key) } -> std::convertible_to<size_t>;
+        };
+
+        /// String view over single-byte characters
+        template<typename T>
+        concept CByteStringView = std::same_as<T, std::basic_string_view<typename T::value_type, typename T::traits_type>>
+                                  && sizeof(typename T::value_type) == 1;
+    }
+
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements and the dictionary size
+    /// @tparam TElementSerdes Serdes used to serialize/deserialize the dictionary values
+    /// @tparam TValueType Sequential container type
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType>
+    requires (TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+    struct Dict
+    {
+        /// Serdes for serializing/deserializing the number of elements and the dictionary size
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing the dictionary values
+        using ElementSerdes = TElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = TValueType;
+
+        /// Code width meaning varint codes
+        static constexpr uint8_t varintCodes = 0;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Dict; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        /// Width of the codes for a dictionary of the given size
+        [[nodiscard]] static constexpr
+        uint8_t CodeWidth(uint64_t dictSize) noexcept
+        {
+            return dictSize <= 0x100 ? 1 : dictSize <= 0x10000 ? 2 : varintCodes;
+        }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+            constexpr uint32_t maxSize = std::numeric_limits<ValueT<SizeSerdes>>::max();
+            return Safe::Add(Safe::Add(Safe::Mul(SizeSerdes::Sizeof(), 2), 1),
+                             Safe::Mul(maxSize, Safe::Add(ElementSerdes::Sizeof(), Varint<uint32_t>::Sizeof())));
+        }
+
+        /// Builds the dictionary to determine the size
+        /// @note This function may return WRONG_SIZE if an overflow occurs during computation
+        /// or if the range size exceeds the maximum allowed value
+        template<std::ranges::forward_range TRange>
+        requires details::CHashableDictKey<std::ranges::range_value_t<TRange>>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+
+            if(std::ranges::size(range) > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+
+            const auto encoding = Encode(range);
+
+            uint32_t bufSize = 2 * SizeSerdes::Sizeof() + 1;
+            for(const auto *value: encoding.values)
+                bufSize = Safe::Add(bufSize, ElementSerdes::Sizeof(*value));
+
+            const uint8_t width = CodeWidth(encoding.values.size());
+            if(width == varintCodes)
+                for(uint32_t code: encoding.codes)
+                    bufSize = Safe::Add(bufSize, details::VarintSize(code));
+            else
+                bufSize = Safe::Add(bufSize, Safe::Mul(static_cast<uint32_t>(encoding.codes.size()), uint32_t{width}));
+
+            return bufSize;
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        requires details::CHashableDictKey<std::ranges::range_value_t<TRange>>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            if(std::ranges::size(range) > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            const auto encoding = Encode(range);
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, encoding.codes.size());
+            bufpos = SizeSerdes::SerializeTo(bufpos, encoding.values.size());
+            for(const auto *value: encoding.values)
+                bufpos = ElementSerdes::SerializeTo(bufpos, *value);
+
+            const uint8_t width = CodeWidth(encoding.values.size());
+            bufpos = Pod<uint8_t>::SerializeTo(bufpos, width);
+
+            for(uint32_t code: encoding.codes)
+                if(width == 1)
+                    bufpos = Pod<uint8_t>::SerializeTo(bufpos, code);
+                else if(width == 2)
+                    bufpos = Pod<uint16_t>::SerializeTo(bufpos, code);
+                else
+                    bufpos = details::SerializeVarint(bufpos, code);
+
+            return bufpos;
+        }
+
+        /// @throw std::runtime_error if a code is outside the dictionary or the code width is invalid
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            using TargetType = std::ranges::range_value_t<TSequence>;
+
+            ValueT<SizeSerdes> size{0}, dictSize{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, dictSize);
+
+            // String views refer to the dictionary values in the buffer
+            if constexpr (details::CByteStringView<TargetType>)
+            {
+                static_assert(CContiguousByteIterator<TInputIterator>,
+                              "Dict: string views can be deserialized only from a contiguous buffer");
+                static_assert(details::CRangeSerdes<ElementSerdes>
+                              && CRawPod<typename ElementSerdes::ElementSerdes, typename TargetType::value_type>,
+                              "Dict: the element serdes must serialize strings as their characters");
+
+                std::vector<TargetType> dictionary(dictSize);
+                for(TargetType &value: dictionary)
+                {
+                    ValueT<typename ElementSerdes::SizeSerdes> length{0};
+                    bufpos = ElementSerdes::SizeSerdes::DeserializeFrom(bufpos, length);
+                    value = TargetType(reinterpret_cast<const typename TargetType::value_type *>(std::to_address(bufpos)), length);
+                    bufpos += length;
+                }
+
+                return DeserializeCodes(bufpos, sequence, size, dictionary);
+            }
+            else
+            {
+                std::vector<ElementType> dictionary(dictSize);
+                for(ElementType &value: dictionary)
+                    bufpos = ElementSerdes::DeserializeFrom(bufpos, value);
+
+                return DeserializeCodes(bufpos, sequence, size, dictionary);
+            }
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0}, dictSize{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, dictSize);
+
+            for(uint32_t i = 0; i < dictSize; i++)
+                bufpos = serdes::Skip<ElementSerdes>(bufpos);
+
+            uint8_t width = 0;
+            bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, width);
+            if(width != varintCodes)
+                return details::Advance(bufpos, static_cast<uint64_t>(size) * width);
+
+            for(uint32_t i = 0; i < size; i++)
+                bufpos = details::SkipVarint(bufpos);
+            return bufpos;
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        /// @throw std::runtime_error if the code width is invalid
+        // Stage 1: Count is the number of elements; stage 2: the dictionary has been scheduled
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                ValueT<SizeSerdes> size{0};
+                if(!cursor.template Read<SizeSerdes>(size))
+                    return false;
+                cursor.Count() = size;
+                cursor.Stage() = 1;
+            }
+
+            if(cursor.Stage() == 1)
+            {
+                ValueT<SizeSerdes> dictSize{0};
+                if(!cursor.template Read<SizeSerdes>(dictSize))
+                    return false;
+                cursor.Stage() = 2;
+                cursor.template Then<ElementSerdes>(dictSize);
+                return true;
+            }
+
+            uint8_t width = 0;
+            if(!cursor.template Read<Pod<uint8_t>>(width))
+                return false;
+            if(width != 1 && width != 2 && width != varintCodes)
+                utils::Throw<std::runtime_error>("invalid width of dictionary codes");
+
+            const uint64_t size = cursor.Count();
+            cursor.Finish();
+            if(width == varintCodes)
+                cursor.Varints(size);
+            else
+                cursor.Bytes(size * width);
+            return true;
+        }
+
+    private:
+        /// Dictionary of a range
+        template<std::ranges::forward_range TRange>
+        struct Encoding
+        {
+            /// Distinct values in the order of first occurrence
+            std::vector<const std::ranges::range_value_t<TRange> *> values;
+
+            /// Codes of the elements
+            std::vector<uint32_t> codes;
+        };
+
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        Encoding<TRange> Encode(const TRange &range)
+        {
+            using Key = typename details::DictKey<std::ranges::range_value_t<TRange>>::Type;
+
+            Encoding<TRange> encoding;
+            encoding.codes.reserve(std::ranges::size(range));
+
+            std::unordered_map<Key, uint32_t> codes;
+            for(const auto &element: range)
+            {
+                const auto [it, inserted] = codes.try_emplace(Key(element), static_cast<uint32_t>(encoding.values.size()));
+                if(inserted)
+                    encoding.values.push_back(std::addressof(element));
+                encoding.codes.push_back(it->second);
+            }
+
+            return encoding;
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence, typename TDictValue>
+        static constexpr
+        TInputIterator DeserializeCodes(TInputIterator bufpos, TSequence &sequence, size_t size,
+                                        const std::vector<TDictValue> &dictionary)
+        {
+            uint8_t width = 0;
+            bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, width);
+            if(width != 1 && width != 2 && width != varintCodes)
+                utils::Throw<std::runtime_error>("invalid width of dictionary codes");
+
+            sequence.resize(size);
+            for(auto &element: sequence)
+            {
+                uint64_t code = 0;
+                if(width == 1)
+                {
+                    uint8_t code8 = 0;
+                    bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, code8);
+                    code = code8;
+                }
+                else if(width == 2)
+                {
+                    uint16_t code16 = 0;
+                    bufpos = Pod<uint16_t>::DeserializeFrom(bufpos, code16);
+                    code = code16;
+                }
+                else
+                    bufpos = details::DeserializeVarint(bufpos, code);
+
+                if(code >= dictionary.size())
+                    utils::Throw<std::runtime_error>("dictionary code is out of range");
+                element = dictionary[code];
+            }
+
+            return bufpos;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
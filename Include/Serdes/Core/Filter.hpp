@@ -0,0 +1,123 @@
+#ifndef SERDES_CORE_FILTER_HPP
+#define SERDES_CORE_FILTER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Filtered deserialization of record sequences
+
+    @details
+        DeserializeIf decodes a range of tuple records (for example, Vector<Tuple<...>>)
+        and keeps only the records accepted by a predicate. The predicate receives the
+        key fields of a record, which are decoded first. The remaining fields are
+        decoded only for accepted records; for rejected records they are skipped
+        using Skip, without deserialization.
+
+        Records stored one per entry of a record log are filtered by the
+        RecordLogReader overload declared in Io/RecordLog.hpp.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <tuple>
+#include <ranges>
+#include <algorithm>
+#include <utility>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Deserializes a tuple record if it is accepted by a predicate
+        /// @return Iterator pointing to the buffer position immediately after the record
+        template<CSerdes TRecordSerdes, size_t ...keys, std::forward_iterator TInputIterator, typename TContainer, typename TPredicate>
+        constexpr
+        TInputIterator DeserializeRecordIf(TInputIterator bufpos, TContainer &container, TPredicate &predicate)
+        {
+            using SerdesList = typename TRecordSerdes::SerdesList;
+            using RecordType = std::ranges::range_value_t<TContainer>;
+
+            constexpr size_t fieldCount = std::tuple_size_v<SerdesList>;
+            constexpr size_t lastKey = std::max({keys...});
+            static_assert(lastKey < fieldCount, "DeserializeIf: key index out of range");
+            static_assert(!TRecordSerdes::hasBitFields, "DeserializeIf: records with bit fields are not supported");
+
+            // Determines whether the field is a key field
+            constexpr auto isKey = [](size_t index) { return ((index == keys) || ...); };
+
+            // Positions of non-key fields preceding the last key field
+            std::array<TInputIterator, lastKey + 1> fieldPos{};
+
+            // Each record is value-initialized: a moved-from record may still share
+            // state with the accepted one (e.g. the pointee of a raw pointer field)
+            RecordType record{};
+
+            // Decode key fields, skip (and remember) the others up to the last key field
+            [&]<size_t ...I>(std::index_sequence<I...>) constexpr
+            {
+                ((isKey(I) ? (bufpos = std::tuple_element_t<I, SerdesList>::DeserializeFrom(bufpos, std::get<I>(record)))
+                           : (fieldPos[I] = bufpos, bufpos = Skip<std::tuple_element_t<I, SerdesList>>(bufpos))), ...);
+            }(std::make_index_sequence<lastKey + 1>{});
+
+            if(predicate(std::as_const(std::get<keys>(record))...))
+            {
+                // Decode the remembered fields and the fields following the last key field
+                [&]<size_t ...I>(std::index_sequence<I...>) constexpr
+                {
+                    ((isKey(I) ? void() : (void)std::tuple_element_t<I, SerdesList>::DeserializeFrom(fieldPos[I], std::get<I>(record))), ...);
+                }(std::make_index_sequence<lastKey + 1>{});
+
+                [&]<size_t ...I>(std::index_sequence<I...>) constexpr
+                {
+                    ((bufpos = std::tuple_element_t<lastKey + 1 + I, SerdesList>::DeserializeFrom(bufpos, std::get<lastKey + 1 + I>(record))), ...);
+                }(std::make_index_sequence<fieldCount - lastKey - 1>{});
+
+                container.insert(container.end(), std::move(record));
+            }
+            else
+                [&]<size_t ...I>(std::index_sequence<I...>) constexpr
+                {
+                    ((bufpos = Skip<std::tuple_element_t<lastKey + 1 + I, SerdesList>>(bufpos)), ...);
+                }(std::make_index_sequence<fieldCount - lastKey - 1>{});
+
+            return bufpos;
+        }
+    }
+
+    /// Deserializes the records of a range accepted by a predicate
+    /// @tparam TSerdes Range serdes (Sequence, Assoc) whose elements are serialized with a Tuple serdes
+    /// @tparam keys Indices of the record fields passed to the predicate
+    /// @param bufpos Iterator pointing to the serialized range
+    /// @param container Container to which the accepted records are appended
+    /// @param predicate Callable entity taking the key fields (in the order of keys) and returning bool
+    /// @return Iterator pointing to the buffer position immediately after the range
+    /// @note Positions of skipped fields preceding the last key field are remembered,
+    /// so the iterator must be a forward iterator.
+    template<CSerdes TSerdes, size_t ...keys, std::forward_iterator TInputIterator, typename TContainer, typename TPredicate>
+    requires (sizeof...(keys) > 0
+              && details::CRangeSerdes<TSerdes>
+              && details::CListSerdes<typename TSerdes::ElementSerdes>
+              && TSerdes::ElementSerdes::GetTypeId() == TypeId::Tuple)
+    constexpr
+    TInputIterator DeserializeIf(TInputIterator bufpos, TContainer &container, TPredicate predicate)
+    {
+        ValueT<typename TSerdes::SizeSerdes> size{0};
+        bufpos = TSerdes::SizeSerdes::DeserializeFrom(bufpos, size);
+
+        for(uint32_t r = 0; r < size; r++)
+            bufpos = details::DeserializeRecordIf<typename TSerdes::ElementSerdes, keys...>(bufpos, container, predicate);
+
+        return bufpos;
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,149 @@
+#ifndef SERDES_CORE_FINGERPRINT_HPP
+#define SERDES_CORE_FINGERPRINT_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Compile-time fingerprint of the serialized layout of a serdes
+
+    @details
+        The fingerprint is a 64-bit FNV-1a hash of the structure of a serdes:
+        type identifiers, POD type identifiers, sizes, and the fingerprints of
+        the nested serdes. Serdes with the same wire layout have the same
+        fingerprint; for example, a Struct and the Tuple it is based on.
+
+        Parameters that change the layout of a serdes without changing its
+        structure (chunk and block sizes, bit counts, decimal scales) are declared
+        by the serdes and hashed in order:
+
+            static constexpr std::array<uint64_t, 1> layoutParameters{blockSize};
+
+        A serdes can define its own fingerprint (for example, to distinguish
+        message types with identical layouts) with a static member:
+
+            static constexpr uint64_t fingerprint = 0x...;
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <tuple>
+#include <iterator>
+#include <cstdint>
+#include <type_traits>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Serdes defining its own fingerprint
+        template<typename TSerdes>
+        concept CFingerprintedSerdes = requires
+        {
+            { TSerdes::fingerprint } -> std::convertible_to<uint64_t>;
+        };
+
+        /// POD serdes
+        template<typename TSerdes>
+        concept CPodSerdes = requires { { TSerdes::GetPodId() } -> std::same_as<PodTypeId>; };
+
+        /// Serdes declaring the parameters of its layout
+        template<typename TSerdes>
+        concept CLayoutParameters = requires
+        {
+            { std::size(TSerdes::layoutParameters) } -> std::convertible_to<size_t>;
+            { TSerdes::layoutParameters[0] } -> std::convertible_to<uint64_t>;
+        };
+
+        /// Incremental 64-bit FNV-1a hash
+        struct Fnv1a
+        {
+            uint64_t value = 0xcbf29ce484222325ull;
+
+            constexpr
+            Fnv1a &Add(uint64_t data, size_t bytes = 8) noexcept
+            {
+                for(size_t i = 0; i < bytes; i++)
+                {
+                    value ^= static_cast<uint8_t>(data >> (i * 8));
+                    value *= 0x100000001b3ull;
+                }
+                return *this;
+            }
+        };
+
+        template<CSerdes TSerdes>
+        consteval
+        uint64_t ComputeFingerprint();
+
+        template<typename TSerdesList>
+        consteval
+        uint64_t ListFingerprint()
+        {
+            return []<typename ...TSerdes>(std::tuple<TSerdes...> *)
+            {
+                Fnv1a hash;
+                hash.Add(sizeof...(TSerdes), 1);
+                (hash.Add(ComputeFingerprint<TSerdes>()), ...);
+                return hash.value;
+            }(static_cast<TSerdesList *>(nullptr));
+        }
+
+        template<CSerdes TSerdes>
+        consteval
+        uint64_t ComputeFingerprint()
+        {
+            if constexpr (CFingerprintedSerdes<TSerdes>)
+                return TSerdes::fingerprint;
+
+            // Struct and Custom have the layout of their base serdes
+            else if constexpr (CBasedSerdes<TSerdes>)
+                return ComputeFingerprint<typename TSerdes::BaseSerdes>();
+
+            else
+            {
+                Fnv1a hash;
+                hash.Add(static_cast<uint8_t>(TSerdes::GetTypeId()), 1);
+
+                if constexpr (CPodSerdes<TSerdes>)
+                    hash.Add(static_cast<uint8_t>(TSerdes::GetPodId()), 1).Add(TSerdes::Sizeof(), 4);
+
+                else if constexpr (CListSerdes<TSerdes>)
+                    hash.Add(ListFingerprint<typename TSerdes::SerdesList>());
+
+                else if constexpr (requires { typename TSerdes::SizeSerdes; typename TSerdes::ElementSerdes; })
+                    hash.Add(ComputeFingerprint<typename TSerdes::SizeSerdes>())
+                        .Add(ComputeFingerprint<typename TSerdes::ElementSerdes>());
+
+                else if constexpr (CArraySerdes<TSerdes>)
+                    hash.Add(TSerdes::arraySize, 4).Add(ComputeFingerprint<typename TSerdes::ElementSerdes>());
+
+                else if constexpr (CIndirectSerdes<TSerdes>)
+                    hash.Add(ComputeFingerprint<typename TSerdes::SerdesType>());
+
+                // Serdes with an unknown structure are described by the type identifier and the size
+                else
+                    hash.Add(TSerdes::Sizeof(), 4);
+
+                if constexpr (CLayoutParameters<TSerdes>)
+                    for(uint64_t parameter: TSerdes::layoutParameters)
+                        hash.Add(parameter);
+
+                return hash.value;
+            }
+        }
+    }
+
+    /// Fingerprint of the serialized layout of a serdes
+    template<CSerdes ...TSerdes>
+    inline constexpr uint64_t Fingerprint = details::ComputeFingerprint<SerdesT<TSerdes...>>();
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
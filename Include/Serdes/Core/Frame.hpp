@@ -0,0 +1,303 @@
+#ifndef SERDES_CORE_FRAME_HPP
+#define SERDES_CORE_FRAME_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Framing of messages of different types and dispatching of frames to typed handlers
+
+    @details
+        A frame consists of the length of the message, the key of the message
+        type and the message:
+
+            [length: UInt32][key: UInt64][message]
+
+        The key is the fingerprint of the message serdes (see Fingerprint.hpp),
+        computed at compile time. Dispatcher maps the key of an incoming frame
+        to the index of the message type through a perfect hash table built at
+        compile time, deserializes the message and calls the handler with the
+        tag of the message serdes (std::type_identity<TSerdes>) and the message.
+        The tag distinguishes message types that share a value type. Frames with
+        unknown keys are skipped using the length.
+
+            struct Handler
+            {
+                void operator()(std::type_identity<Login>, ValueT<Login> &login) { ... }
+                void operator()(std::type_identity<Order>, ValueT<Order> &order) { ... }
+                void operator()(std::type_identity<Cancel>, ValueT<Cancel> &cancel) { ... }
+            };
+
+            Dispatcher<Login, Order, Cancel> dispatcher;
+            auto rest = dispatcher.DispatchAll(data.begin(), data.end(), Handler{});
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <tuple>
+#include <vector>
+#include <format>
+#include <ranges>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Typedefs.hpp"
+#include "Fingerprint.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// Header of a frame
+    struct FrameHeader
+    {
+        /// Size of the serialized header
+        static constexpr uint32_t size = 12;
+
+        /// Length of the message
+        uint32_t length;
+
+        /// Key of the message type
+        uint64_t key;
+    };
+
+    namespace details
+    {
+        using FrameLengthSerdes = UInt32;
+        using FrameKeySerdes = UInt64;
+
+        /// Parameters of a perfect hash: slot = (key * multiplier) >> (64 - bits)
+        struct PerfectHash
+        {
+            uint64_t multiplier;
+            unsigned bits;
+        };
+
+        /// Finds a multiplicative perfect hash for a set of distinct keys; the table
+        /// is enlarged (up to 256 times the smallest power-of-two size) until a
+        /// collision-free multiplier is found
+        template<size_t keyCount>
+        consteval
+        PerfectHash FindPerfectHash(const std::array<uint64_t, keyCount> &keys)
+        {
+            constexpr unsigned extraBits = 8;
+
+            unsigned minBits = 1;
+            while((size_t{1} << minBits) < keyCount)
+                minBits++;
+
+            // Slot marks of the current attempt; marks of previous attempts are ignored
+            std::vector<unsigned> marks(size_t{1} << (minBits + extraBits), 0);
+            unsigned mark = 0;
+
+            for(unsigned bits = minBits; bits <= minBits + extraBits; bits++)
+            {
+                // Odd multipliers from the SplitMix64 sequence
+                uint64_t state = 0;
+                for(unsigned attempt = 0; attempt < 256; attempt++)
+                {
+                    state += 0x9e3779b97f4a7c15ull;
+                    uint64_t z = state;
+                    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+                    const uint64_t multiplier = (z ^ (z >> 31)) | 1;
+
+                    mark++;
+                    bool perfect = true;
+                    for(uint64_t key: keys)
+                    {
+                        const size_t slot = static_cast<size_t>((key * multiplier) >> (64 - bits));
+                        if(marks[slot] == mark)
+                        {
+                            perfect = false;
+                            break;
+                        }
+                        marks[slot] = mark;
+                    }
+
+                    if(perfect)
+                        return {multiplier, bits};
+                }
+            }
+
+            utils::Throw<std::logic_error>("no perfect hash found for the message keys");
+        }
+    }
+
+    /// Determines the buffer size required to serialize a message frame
+    /// @return Buffer size or WRONG_SIZE if the allowed size is exceeded
+    template<CSerdes TSerdes, typename TValue>
+    [[nodiscard]] constexpr
+    uint32_t SizeofFrame(const TValue &value)
+    {
+        return utils::Safe<utils::policy::MaxValue>::Add(FrameHeader::size, TSerdes::Sizeof(value));
+    }
+
+    /// Serializes a message frame
+    /// @return Iterator pointing to the buffer position immediately after the frame
+    /// @throw std::length_error if the message size exceeds the allowed limit
+    template<CSerdes TSerdes, COutputIterator TOutputIterator, typename TValue>
+    constexpr
+    TOutputIterator SerializeFrameTo(TOutputIterator bufpos, const TValue &value)
+    {
+        const uint32_t length = TSerdes::Sizeof(value);
+        if(length == WRONG_SIZE)
+            utils::Throw<std::length_error>("message size exceeds the allowed limit");
+
+        bufpos = details::FrameLengthSerdes::SerializeTo(bufpos, length);
+        bufpos = details::FrameKeySerdes::SerializeTo(bufpos, Fingerprint<TSerdes>);
+        return TSerdes::SerializeTo(bufpos, value);
+    }
+
+    /// Serializes a message frame into an automatically created buffer
+    template<CSerdes TSerdes, typename TValue>
+    [[nodiscard]] constexpr
+    std::vector<uint8_t> SerializeFrame(const TValue &value)
+    {
+        std::vector<uint8_t> buf(SizeofFrame<TSerdes>(value));
+        SerializeFrameTo<TSerdes>(buf.begin(), value);
+        return buf;
+    }
+
+    /// Deserializes a frame header
+    template<CInputIterator TInputIterator>
+    constexpr
+    TInputIterator DeserializeFrom(TInputIterator bufpos, FrameHeader &header)
+    {
+        bufpos = details::FrameLengthSerdes::DeserializeFrom(bufpos, header.length);
+        return details::FrameKeySerdes::DeserializeFrom(bufpos, header.key);
+    }
+
+    //--------------------------------------------------------------------------
+    /// Dispatcher of frames to typed handlers
+    /// @tparam TSerdes Serdes of the message types; their fingerprints must be distinct
+    template<CSerdes ...TSerdes>
+    requires (sizeof...(TSerdes) > 0 && sizeof...(TSerdes) < 0xFFFF)
+    class Dispatcher
+    {
+        static constexpr size_t typeCount = sizeof...(TSerdes);
+
+        static constexpr std::array<uint64_t, typeCount> keys{Fingerprint<TSerdes>...};
+
+        static_assert([]
+        {
+            auto sorted = keys;
+            std::ranges::sort(sorted);
+            return std::ranges::adjacent_find(sorted) == sorted.end();
+        }(), "Dispatcher: message types have identical fingerprints, define TSerdes::fingerprint to distinguish them");
+
+        static constexpr details::PerfectHash hash = details::FindPerfectHash(keys);
+
+        [[nodiscard]] static constexpr
+        size_t Slot(uint64_t key) noexcept { return static_cast<size_t>((key * hash.multiplier) >> (64 - hash.bits)); }
+
+        /// Index of the message type plus one for each slot (0 - empty slot)
+        static constexpr auto slots = []
+        {
+            std::array<uint16_t, (size_t{1} << hash.bits)> result{};
+            for(size_t i = 0; i < typeCount; i++)
+                result[Slot(keys[i])] = static_cast<uint16_t>(i + 1);
+            return result;
+        }();
+
+    public:
+        /// Returns the index of the message type with the given key or -1 if the key is unknown
+        [[nodiscard]] static constexpr
+        int Find(uint64_t key) noexcept
+        {
+            const size_t index = slots[Slot(key)];
+            return index && keys[index - 1] == key ? static_cast<int>(index - 1) : -1;
+        }
+
+        /// Dispatches a single complete frame
+        /// @param first Iterator pointing to the frame
+        /// @param last Iterator pointing to the end of the data
+        /// @param handler Callable entity with an overload for each message serdes, taking
+        /// std::type_identity<TSerdes> and a reference to the message.
+        /// The message objects are reused by subsequent calls.
+        /// @return Iterator pointing to the position after the frame and whether the frame was handled
+        /// (false for frames with unknown keys, which are skipped)
+        /// @throw std::runtime_error if the frame is incomplete or its length does not match the message
+        template<std::random_access_iterator TInputIterator, typename THandler>
+        requires CInputIterator<TInputIterator>
+        std::ranges::in_found_result<TInputIterator> Dispatch(TInputIterator first, TInputIterator last, THandler &&handler)
+        {
+            static_assert((std::invocable<THandler &, std::type_identity<TSerdes>, ValueT<TSerdes> &> && ...),
+                          "Dispatcher: the handler must accept every message type");
+
+            FrameHeader header;
+            if(!IsComplete(first, last, header))
+                utils::Throw<std::runtime_error>("incomplete frame");
+
+            const TInputIterator message = first + FrameHeader::size;
+            const TInputIterator next = message + header.length;
+
+            const int index = Find(header.key);
+            if(index < 0)
+                return {next, false};
+
+            handlers<TInputIterator, THandler>[index](*this, message, next, handler);
+            return {next, true};
+        }
+
+        /// Dispatches all complete frames
+        /// @return Iterator pointing to the first incomplete frame (or to the end of the data)
+        template<std::random_access_iterator TInputIterator, typename THandler>
+        requires CInputIterator<TInputIterator>
+        TInputIterator DispatchAll(TInputIterator first, TInputIterator last, THandler &&handler)
+        {
+            FrameHeader header;
+            while(IsComplete(first, last, header))
+                first = Dispatch(first, last, handler).in;
+            return first;
+        }
+
+    private:
+        /// Reads the frame header and checks whether the whole frame is available
+        template<std::random_access_iterator TInputIterator>
+        static constexpr
+        bool IsComplete(TInputIterator first, TInputIterator last, FrameHeader &header)
+        {
+            using Difference = std::iter_difference_t<TInputIterator>;
+
+            if(last - first < static_cast<Difference>(FrameHeader::size))
+                return false;
+
+            DeserializeFrom(first, header);
+            return last - first - static_cast<Difference>(FrameHeader::size) >= static_cast<Difference>(header.length);
+        }
+
+        template<size_t index, typename TInputIterator, typename THandler>
+        static
+        void Handle(Dispatcher &self, TInputIterator message, TInputIterator next, THandler &handler)
+        {
+            using Serdes = std::tuple_element_t<index, std::tuple<TSerdes...>>;
+
+            auto &value = std::get<index>(self._values);
+            if(Serdes::DeserializeFrom(message, value) != next)
+                utils::Throw<std::runtime_error>(std::format("frame length does not match the message of type {}", index));
+            handler(std::type_identity<Serdes>{}, value);
+        }
+
+        /// Handlers of the message types, indexed like TSerdes
+        template<typename TInputIterator, typename THandler>
+        static constexpr auto handlers = []<size_t ...indices>(std::index_sequence<indices...>)
+        {
+            return std::array<void (*)(Dispatcher &, TInputIterator, TInputIterator, THandler &), typeCount>{
+                &Handle<indices, TInputIterator, THandler>...};
+        }(std::index_sequence_for<TSerdes...>{});
+
+        /// Message objects reused between frames
+        std::tuple<ValueT<TSerdes>...> _values;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -12,7 +12,9 @@
     @author Niraleks
 */
 //------------------------------------------------------------------------------
+#include <ranges>
 #include <iterator>
+#include <type_traits>
 #include "Typeids.hpp"
 #include "Concepts.hpp"
 
@@ -52,6 +54,26 @@ namespace serdes
         {
             using Type = Tuple<>;
         };
+
+        /// Range whose elements are produced as temporaries (for example, a transform view)
+        template<typename TRange>
+        concept CTransientElements = !std::is_lvalue_reference_v<std::ranges::range_reference_t<const TRange>>;
+
+        /// Serializes data that may be destroyed before the output is consumed
+        /// @param serialize Callable entity taking and returning the output iterator
+        // Iterators that reference written blocks are switched to copying them
+        template<bool transient = true, COutputIterator TOutputIterator, typename TSerialize>
+        constexpr
+        TOutputIterator SerializeTransient(TOutputIterator bufpos, TSerialize &&serialize)
+        {
+            if constexpr (transient && CReferencingOutputIterator<TOutputIterator>)
+            {
+                const bool copies = bufpos.CopiesBlocks();
+                return serialize(bufpos.CopyBlocks(true)).CopyBlocks(copies);
+            }
+            else
+                return serialize(bufpos);
+        }
     }
 
     /// Helper alias to simplify obtaining a serdes type.
@@ -0,0 +1,235 @@
+#ifndef SERDES_CORE_LZ_HPP
+#define SERDES_CORE_LZ_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Dependency-free LZ77 block codec
+
+    @details
+        The block format follows LZ4: a block is a series of sequences, each
+        consisting of
+
+            [token][literal length extension][literals][offset: 2 bytes][match length extension]
+
+        The high 4 bits of the token hold the number of literals and the low
+        4 bits hold the match length minus 4; the value 15 means that the
+        length continues in the following bytes (each byte is added, 255 means
+        that one more byte follows). The offset is the distance back to the
+        match in the decompressed data (little-endian, 1..65535); matches may
+        overlap the data they produce. The last sequence contains only
+        literals and ends the block. The last 5 bytes of a block are always
+        literals and a match does not start within the last 12 bytes.
+
+        The compressor uses a single-probe hash table of 4-byte sequences and
+        skips faster through incompressible data, favouring speed over ratio.
+        The table is allocated once per thread; only the part used for the size
+        of the block is cleared, so small blocks are compressed quickly.
+        The decompressor checks all lengths and offsets, so corrupted input
+        is detected instead of causing out-of-bounds access.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <bit>
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        struct Lz
+        {
+            static constexpr size_t minMatch = 4;
+            static constexpr size_t lastLiterals = 5;
+            static constexpr size_t matchFindLimit = 12;
+            static constexpr size_t maxOffset = 65535;
+            static constexpr unsigned hashBits = 14;
+            static constexpr unsigned minHashBits = 8;
+
+            /// Compresses a block
+            /// @param capacity Size of the output buffer
+            /// @return Size of the compressed data or 0 if it does not fit into the output buffer
+            static
+            size_t Compress(const uint8_t *src, size_t size, uint8_t *dst, size_t capacity)
+            {
+                // The output depends only on the block: the used part of the table is cleared
+                thread_local std::array<uint32_t, size_t{1} << hashBits> table;
+                const unsigned bits = std::min(std::max<unsigned>(std::bit_width(size), minHashBits + 2) - 2, hashBits);
+                std::fill_n(table.begin(), size_t{1} << bits, 0);
+
+                size_t out = 0;
+                size_t anchor = 0;
+
+                if(size > matchFindLimit)
+                {
+                    const size_t limit = size - matchFindLimit;
+                    const size_t matchLimit = size - lastLiterals;
+
+                    size_t pos = 1;
+                    while(pos < limit)
+                    {
+                        const uint32_t sequence = Load32(src + pos);
+                        uint32_t &slot = table[Hash(sequence, bits)];
+                        const size_t candidate = slot;
+                        slot = static_cast<uint32_t>(pos);
+
+                        if(candidate >= pos || pos - candidate > maxOffset || Load32(src + candidate) != sequence)
+                        {
+                            // Incompressible data is skipped with an increasing step
+                            pos += 1 + ((pos - anchor) >> 6);
+                            continue;
+                        }
+
+                        size_t length = minMatch;
+                        while(pos + length < matchLimit && src[candidate + length] == src[pos + length])
+                            length++;
+
+                        if(!PutSequence(src + anchor, pos - anchor, pos - candidate, length, dst, capacity, out))
+                            return 0;
+
+                        pos += length;
+                        anchor = pos;
+
+                        if(pos - 2 < limit)
+                            table[Hash(Load32(src + pos - 2), bits)] = static_cast<uint32_t>(pos - 2);
+                    }
+                }
+
+                if(!PutSequence(src + anchor, size - anchor, 0, 0, dst, capacity, out))
+                    return 0;
+                return out;
+            }
+
+            /// Decompresses a block
+            /// @return false if the data is corrupted or does not decompress to exactly size bytes
+            [[nodiscard]] static
+            bool Decompress(const uint8_t *src, size_t srcSize, uint8_t *dst, size_t size) noexcept
+            {
+                size_t in = 0;
+                size_t out = 0;
+
+                while(in < srcSize)
+                {
+                    const uint8_t token = src[in++];
+
+                    size_t literals = token >> 4;
+                    if(!GetLength(src, srcSize, in, literals) || srcSize - in < literals || size - out < literals)
+                        return false;
+
+                    if(literals)
+                        std::memcpy(dst + out, src + in, literals);
+                    in += literals;
+                    out += literals;
+
+                    // The last sequence has no match
+                    if(in == srcSize)
+                        return out == size;
+
+                    if(srcSize - in < 2)
+                        return false;
+                    const size_t offset = src[in] | size_t{src[in + 1]} << 8;
+                    in += 2;
+
+                    size_t length = token & 0x0F;
+                    if(offset == 0 || offset > out || !GetLength(src, srcSize, in, length))
+                        return false;
+                    length += minMatch;
+                    if(size - out < length)
+                        return false;
+
+                    // Overlapping matches repeat the preceding bytes
+                    uint8_t *match = dst + out - offset;
+                    if(offset >= length)
+                        std::memcpy(dst + out, match, length);
+                    else
+                        for(size_t i = 0; i < length; i++)
+                            dst[out + i] = match[i];
+                    out += length;
+                }
+
+                return false;
+            }
+
+        private:
+            static
+            uint32_t Load32(const uint8_t *p) noexcept
+            {
+                uint32_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            }
+
+            static
+            size_t Hash(uint32_t sequence, unsigned bits) noexcept { return (sequence * 2654435761u) >> (32 - bits); }
+
+            /// Writes a sequence; a sequence without a match (length 0) ends the block
+            static
+            bool PutSequence(const uint8_t *literals, size_t literalCount, size_t offset, size_t length,
+                             uint8_t *dst, size_t capacity, size_t &out)
+            {
+                const size_t matchCode = length ? length - minMatch : 0;
+                const size_t required = 1 + literalCount / 255 + 1 + literalCount + (length ? 2 + matchCode / 255 + 1 : 0);
+                if(capacity - out < required)
+                    return false;
+
+                uint8_t &token = dst[out++];
+                token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+                PutLength(literalCount, dst, out);
+
+                if(literalCount)
+                    std::memcpy(dst + out, literals, literalCount);
+                out += literalCount;
+
+                if(length)
+                {
+                    dst[out++] = static_cast<uint8_t>(offset);
+                    dst[out++] = static_cast<uint8_t>(offset >> 8);
+                    token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+                    PutLength(matchCode, dst, out);
+                }
+                return true;
+            }
+
+            /// Writes the extension of a length that does not fit into 4 bits of the token
+            static
+            void PutLength(size_t length, uint8_t *dst, size_t &out) noexcept
+            {
+                if(length < 15)
+                    return;
+                for(length -= 15; length >= 255; length -= 255)
+                    dst[out++] = 255;
+                dst[out++] = static_cast<uint8_t>(length);
+            }
+
+            static
+            bool GetLength(const uint8_t *src, size_t srcSize, size_t &in, size_t &length) noexcept
+            {
+                if(length < 15)
+                    return true;
+
+                uint8_t byte;
+                do
+                {
+                    if(in == srcSize)
+                        return false;
+                    byte = src[in++];
+                    length += byte;
+                }
+                while(byte == 255);
+
+                return true;
+            }
+        };
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,380 @@
+#ifndef SERDES_CORE_PACKED_HPP
+#define SERDES_CORE_PACKED_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for integer sequences with frame-of-reference bit packing
+
+    @details
+        Columns whose values cluster in a narrow range (prices in ticks,
+        quantities, ids within a batch) need far fewer bits than the width of
+        their type. The serdes divides the sequence into blocks, subtracts
+        the minimum of each block (frame of reference) from its elements and
+        stores the differences with the number of bits of the largest one.
+
+        Serialized data format:
+
+            [n][block 1] ... [block k]
+
+            block: [minimum][width][packed differences]
+
+        where n is serialized with the size serdes, the minimum with the
+        element serdes, the width (UInt8, 0..64) is the number of bits per
+        difference, and the differences are packed starting from the least
+        significant bit of the first byte (see BitStream.hpp), taking
+        ceil(count * width / 8) bytes. All blocks except the last one contain
+        blockSize elements. Differences are computed modulo 2^64, as in
+        Delta.hpp, so signed integers and durations are also supported.
+
+        Unlike varints, the decoding has no data-dependent branches: each
+        block is unpacked by a kernel instantiated for its width, which
+        extracts every value with an unaligned 64-bit load and constant
+        shifts, so the compiler unrolls and vectorizes the loop.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <bit>
+#include <array>
+#include <ranges>
+#include <limits>
+#include <cstring>
+#include <utility>
+#include <concepts>
+#include <type_traits>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Delta.hpp"
+#include "BitStream.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Reads 8 bytes as a little-endian word
+        [[nodiscard]] inline
+        uint64_t LoadLe64(const uint8_t *p) noexcept
+        {
+            uint64_t word;
+            if constexpr (std::endian::native == std::endian::little)
+                std::memcpy(&word, p, sizeof(word));
+            else
+            {
+                word = 0;
+                for(unsigned i = 0; i < 8; i++)
+                    word |= static_cast<uint64_t>(p[i]) << 8 * i;
+            }
+            return word;
+        }
+
+        /// Unpacks the value with the given index in a group of 8 values of the given width
+        template<unsigned width, unsigned index>
+        [[nodiscard]] inline
+        uint64_t UnpackField(const uint8_t *group) noexcept
+        {
+            constexpr unsigned bit = index * width;
+            uint64_t value = LoadLe64(group + bit / 8) >> bit % 8;
+
+            // A field wider than 56 bits may extend into the ninth byte
+            if constexpr (width > 56 && bit % 8 != 0)
+                value |= static_cast<uint64_t>(group[bit / 8 + 8]) << (64 - bit % 8);
+
+            return value & LowBits(width);
+        }
+
+        /// Unpacks count values of the given width adding the base to them
+        /// @note The source must contain 9 readable bytes after the last packed byte,
+        /// and the destination must have room for count rounded up to a multiple of 8 values
+        template<std::unsigned_integral T, unsigned width>
+        void UnpackBits(const uint8_t *src, uint64_t base, T *dst, size_t count)
+        {
+            if constexpr (width == 0)
+                std::fill_n(dst, count, static_cast<T>(base));
+            else
+                // 8 values occupy exactly width bytes, so the offsets in a group are constants
+                for(size_t i = 0; i < count; i += 8, src += width, dst += 8)
+                    [&]<unsigned ...indices>(std::integer_sequence<unsigned, indices...>)
+                    {
+                        ((dst[indices] = static_cast<T>(base + UnpackField<width, indices>(src))), ...);
+                    }(std::make_integer_sequence<unsigned, 8>{});
+        }
+
+        /// Unpacking kernels for widths 0..64
+        template<std::unsigned_integral T>
+        inline constexpr auto unpackKernels = []<size_t ...widths>(std::index_sequence<widths...>)
+        {
+            using Kernel = void (*)(const uint8_t *, uint64_t, T *, size_t);
+            return std::array<Kernel, sizeof...(widths)>{ &UnpackBits<T, widths>... };
+        }(std::make_index_sequence<65>{});
+    }
+
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements
+    /// @tparam TElementSerdes Serdes of the block minimums; must be a POD serdes for an integer or a duration
+    /// @tparam TValueType Sequential container type
+    /// @tparam blockSize Number of elements in a block
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType,
+        uint32_t blockSize = 128>
+    requires (TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+             && (TElementSerdes::GetTypeId() == TypeId::Pod)
+             && details::CDeltaValue<ValueT<TElementSerdes>>
+             && (blockSize >= 8 && blockSize <= 4096 && blockSize % 8 == 0)
+    struct Packed
+    {
+        /// Serdes for serializing/deserializing the number of elements
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing the block minimums
+        using ElementSerdes = TElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = TValueType;
+
+        /// Number of elements in a block
+        static constexpr uint32_t blockCapacity = blockSize;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{blockSize};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Packed; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+            constexpr uint32_t maxSize = std::numeric_limits<ValueT<SizeSerdes>>::max();
+            constexpr uint32_t maxBlocks = maxSize / blockSize + (maxSize % blockSize != 0);
+            return Safe::Add(Safe::Add(SizeSerdes::Sizeof(), Safe::Mul(maxBlocks, ElementSerdes::Sizeof() + 1)),
+                             Safe::Mul(maxSize, static_cast<uint32_t>(sizeof(uint64_t))));
+        }
+
+        /// @note This function returns WRONG_SIZE if the range size exceeds the maximum allowed value
+        /// or if the result exceeds the allowed limit
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            if(std::ranges::size(range) > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+
+            uint64_t bufSize = SizeSerdes::Sizeof();
+            ForEachBlock(range, [&bufSize](auto, size_t count, const ElementType &, unsigned width)
+            {
+                bufSize += ElementSerdes::Sizeof() + 1 + PackedBytes(count, width);
+            });
+
+            return bufSize < WRONG_SIZE ? static_cast<uint32_t>(bufSize) : WRONG_SIZE;
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+            ForEachBlock(range, [&bufpos](auto first, size_t count, const ElementType &minimum, unsigned width)
+            {
+                bufpos = ElementSerdes::SerializeTo(bufpos, minimum);
+                bufpos = Pod<uint8_t>::SerializeTo(bufpos, static_cast<uint8_t>(width));
+
+                const uint64_t base = details::ToDeltaInteger(minimum);
+                details::BitWriter writer(bufpos);
+                for(size_t i = 0; i < count; i++, ++first)
+                    writer.Write(details::ToDeltaInteger(static_cast<ElementType>(*first)) - base, width);
+                bufpos = writer.Finish();
+            });
+
+            return bufpos;
+        }
+
+        /// @throw std::runtime_error if the width of a block is invalid
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            sequence.resize(size);
+            auto element = std::ranges::begin(sequence);
+
+            // Integers are unpacked as unsigned values of the same size, durations as 64-bit values
+            using Word = typename std::conditional_t<std::integral<ElementType>,
+                                                     std::make_unsigned<ElementType>,
+                                                     std::type_identity<uint64_t>>::type;
+
+            // Full blocks of integers are unpacked into contiguous containers directly
+            constexpr bool unpackInPlace = std::integral<ElementType>
+                                           && std::ranges::contiguous_range<TSequence>
+                                           && std::same_as<std::ranges::range_value_t<TSequence>, ElementType>;
+
+            // Packed bytes of a block followed by the bytes read by the kernels past its end
+            std::array<uint8_t, blockSize * 8 + 16> packed{};
+            std::array<Word, blockSize> values;
+
+            for(size_t offset = 0; offset < size; offset += blockSize)
+            {
+                const size_t count = std::min<size_t>(blockSize, size - offset);
+
+                ElementType minimum{};
+                uint8_t width = 0;
+                bufpos = ElementSerdes::DeserializeFrom(bufpos, minimum);
+                bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, width);
+                if(width > 64)
+                    utils::Throw<std::runtime_error>("invalid bit width of a packed block");
+
+                const uint64_t base = details::ToDeltaInteger(minimum);
+                if(std::is_constant_evaluated())
+                {
+                    details::BitReader reader(bufpos);
+                    for(size_t i = 0; i < count; i++)
+                        values[i] = static_cast<Word>(base + reader.Read(width));
+                    bufpos = reader.Finish();
+                }
+                else
+                {
+                    const size_t bytes = PackedBytes(count, width);
+                    if constexpr (CContiguousByteIterator<TInputIterator>)
+                    {
+                        std::memcpy(packed.data(), std::to_address(bufpos), bytes);
+                        bufpos += bytes;
+                    }
+                    else
+                        for(size_t i = 0; i < bytes; i++)
+                            packed[i] = static_cast<uint8_t>(*bufpos++);
+
+                    if constexpr (unpackInPlace)
+                        if(count == blockSize)
+                        {
+                            auto *target = reinterpret_cast<Word *>(std::ranges::data(sequence) + offset);
+                            details::unpackKernels<Word>[width](packed.data(), base, target, count);
+                            element += count;
+                            continue;
+                        }
+
+                    details::unpackKernels<Word>[width](packed.data(), base, values.data(), count);
+                }
+
+                element = std::transform(values.begin(), values.begin() + count, element, [](Word value)
+                {
+                    return static_cast<ElementType>(details::FromDeltaInteger<ElementType>(value));
+                });
+            }
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            for(size_t offset = 0; offset < size; offset += blockSize)
+            {
+                uint8_t width = 0;
+                bufpos = Pod<uint8_t>::DeserializeFrom(details::Advance(bufpos, ElementSerdes::Sizeof()), width);
+                bufpos = details::Advance(bufpos, PackedBytes(std::min<size_t>(blockSize, size - offset), width));
+            }
+
+            return bufpos;
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder): one block per call
+        /// @throw std::runtime_error if the width of a block is invalid
+        // Stage 1: Count is the number of unscanned elements
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                ValueT<SizeSerdes> size{0};
+                if(!cursor.template Read<SizeSerdes>(size))
+                    return false;
+                cursor.Count() = size;
+                cursor.Stage() = 1;
+            }
+
+            if(cursor.Count() == 0)
+            {
+                cursor.Finish();
+                return true;
+            }
+
+            // The minimum and the width are read together, so that the block is not scanned partially
+            constexpr size_t headerSize = ElementSerdes::Sizeof() + 1;
+            if(!cursor.Need(headerSize))
+                return false;
+            const uint8_t width = cursor.Data()[headerSize - 1];
+            if(width > 64)
+                utils::Throw<std::runtime_error>("invalid bit width of a packed block");
+            cursor.Consume(headerSize);
+
+            const uint64_t count = std::min<uint64_t>(blockSize, cursor.Count());
+            cursor.Count() -= count;
+            cursor.Bytes(PackedBytes(count, width));
+            return true;
+        }
+
+        /// Number of bytes occupied by count packed values of the given width
+        [[nodiscard]] static constexpr
+        uint64_t PackedBytes(uint64_t count, unsigned width) noexcept { return (count * width + 7) / 8; }
+
+    private:
+        /// Calls the function with the first element, the number of elements, the minimum
+        /// and the bit width of every block
+        template<std::ranges::forward_range TRange, typename TFunction>
+        static constexpr
+        void ForEachBlock(const TRange &range, TFunction &&function)
+        {
+            auto first = std::ranges::begin(range);
+            for(size_t remaining = std::ranges::size(range); remaining; )
+            {
+                const size_t count = std::min<size_t>(blockSize, remaining);
+
+                auto it = first;
+                ElementType minimum = static_cast<ElementType>(*it);
+                ElementType maximum = minimum;
+                for(size_t i = 1; i < count; i++)
+                {
+                    const auto value = static_cast<ElementType>(*++it);
+                    minimum = std::min(minimum, value);
+                    maximum = std::max(maximum, value);
+                }
+
+                const uint64_t spread = details::ToDeltaInteger(maximum) - details::ToDeltaInteger(minimum);
+                function(first, count, minimum, static_cast<unsigned>(std::bit_width(spread)));
+
+                first = std::ranges::next(it);
+                remaining -= count;
+            }
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,327 @@
+#ifndef SERDES_CORE_PARALLEL_HPP
+#define SERDES_CORE_PARALLEL_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Parallel serialization of large ranges
+
+    @details
+        The elements of a random access range are divided into contiguous blocks.
+        The serialized size of each block is computed in parallel, the sizes are
+        prefix-summed into block offsets, and each block is then serialized in
+        parallel into its own region of the output buffer. The serialized data
+        is byte-identical to the result of the serial SerializeTo.
+
+        Sequences serialized with the Chunked serdes record the byte length of
+        every chunk, so their chunks are also deserialized in parallel, directly
+        into the elements of a pre-sized container.
+
+        Work is distributed through an executor, which is any object providing
+
+            void Bulk(size_t count, F &&function); // calls function(i) for i in [0, count)
+
+        and returning after all calls have completed. ThreadExecutor is a minimal
+        executor running the calls on std::jthread workers; a thread pool of the
+        application can be used through a thin adapter.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <ranges>
+#include <limits>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <stdexcept>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// Executor running a number of independent calls
+    template<typename TExecutor>
+    concept CExecutor = requires(TExecutor &executor, void (*function)(size_t))
+    {
+        executor.Bulk(size_t{}, function);
+    };
+
+    /// Executor running the calls of Bulk() on a set of threads created for each call
+    class ThreadExecutor
+    {
+    public:
+        /// @param threads Maximum number of threads (0 - the number of hardware threads)
+        explicit ThreadExecutor(unsigned threads = 0) noexcept
+            : _threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+        {}
+
+        [[nodiscard]]
+        unsigned Threads() const noexcept { return _threads; }
+
+        /// Calls function(i) for i in [0, count) and waits for completion
+        /// @note The first exception thrown by the function is rethrown after all threads have finished
+        template<typename TFunction>
+        void Bulk(size_t count, TFunction &&function)
+        {
+            const size_t threads = std::min<size_t>(_threads, count);
+            if(threads <= 1)
+            {
+                for(size_t i = 0; i < count; i++)
+                    function(i);
+                return;
+            }
+
+            std::atomic<size_t> next{0};
+            std::exception_ptr error;
+            std::atomic_flag failed;
+
+            auto worker = [&]
+            {
+                for(size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+                    try
+                    {
+                        function(i);
+                    }
+                    catch(...)
+                    {
+                        if(!failed.test_and_set())
+                            error = std::current_exception();
+                        next.store(count, std::memory_order_relaxed);
+                    }
+            };
+
+            {
+                std::vector<std::jthread> pool;
+                pool.reserve(threads - 1);
+                for(size_t i = 1; i < threads; i++)
+                    pool.emplace_back(worker);
+                worker();
+            }
+
+            if(error)
+                std::rethrow_exception(error);
+        }
+
+    private:
+        unsigned _threads;
+    };
+
+    namespace details
+    {
+        /// Serdes for sequences divided into chunks of known byte length
+        template<typename TSerdes>
+        concept CChunkedSerdes = requires
+        {
+            typename TSerdes::SizeSerdes;
+            typename TSerdes::ElementSerdes;
+            TSerdes::chunkCapacity;
+        } && (TSerdes::GetTypeId() == TypeId::Chunked);
+
+        /// Division of a range of elements into contiguous blocks
+        struct ParallelBlocks
+        {
+            /// Maximum number of blocks; several blocks per thread balance uneven elements
+            static constexpr size_t maxBlocks = 256;
+
+            /// Minimum number of elements in a block
+            static constexpr size_t minElements = 64;
+
+            size_t elements;
+            size_t count;
+
+            explicit constexpr ParallelBlocks(size_t elements) noexcept
+                : elements(elements)
+                , count(std::clamp<size_t>(elements / minElements, elements ? 1 : 0, maxBlocks))
+            {}
+
+            /// Index of the first element of a block
+            [[nodiscard]] constexpr
+            size_t Begin(size_t block) const noexcept { return count ? elements * block / count : 0; }
+
+            [[nodiscard]] constexpr
+            size_t End(size_t block) const noexcept { return Begin(block + 1); }
+        };
+
+        /// Computes the offsets of serialized blocks relative to the first element;
+        /// the last entry is the total size of the elements
+        template<CSerdes TElementSerdes, CExecutor TExecutor, std::ranges::random_access_range TRange>
+        std::vector<uint64_t> BlockOffsets(TExecutor &executor, const TRange &range, const ParallelBlocks &blocks)
+        {
+            std::vector<uint64_t> offsets(blocks.count + 1, 0);
+            const auto first = std::ranges::begin(range);
+
+            if constexpr (TElementSerdes::GetBufferType() == BufferType::Static)
+                for(size_t block = 0; block <= blocks.count; block++)
+                    offsets[block] = static_cast<uint64_t>(blocks.Begin(block)) * TElementSerdes::Sizeof();
+            else
+            {
+                executor.Bulk(blocks.count, [&](size_t block)
+                {
+                    uint64_t size = 0;
+                    for(size_t i = blocks.Begin(block); i < blocks.End(block); i++)
+                    {
+                        const uint32_t elementSize = TElementSerdes::Sizeof(first[i]);
+                        if(elementSize == WRONG_SIZE)
+                            utils::Throw<std::length_error>("element size exceeds the allowed limit");
+                        size += elementSize;
+                    }
+                    offsets[block + 1] = size;
+                });
+
+                for(size_t block = 0; block < blocks.count; block++)
+                    offsets[block + 1] += offsets[block];
+            }
+
+            return offsets;
+        }
+    }
+
+    /// Determines the buffer size required to serialize a range, computing element sizes in parallel
+    /// @tparam TSerdes Range serdes (for example, Vector)
+    /// @return Buffer size; unlike the serial Sizeof, the result is not limited by WRONG_SIZE
+    /// @throw std::length_error if the number of elements exceeds the limit of the size field
+    template<CSerdes TSerdes, CExecutor TExecutor, std::ranges::random_access_range TRange>
+    requires details::CRangeSerdes<TSerdes>
+    [[nodiscard]]
+    uint64_t Sizeof(TExecutor &executor, const TRange &range)
+    {
+        const size_t size = std::ranges::size(range);
+        if(size > std::numeric_limits<ValueT<typename TSerdes::SizeSerdes>>::max())
+            utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+        const details::ParallelBlocks blocks(size);
+        return TSerdes::SizeSerdes::Sizeof()
+             + details::BlockOffsets<typename TSerdes::ElementSerdes>(executor, range, blocks).back();
+    }
+
+    namespace details
+    {
+        /// Serializes the blocks of a range into the regions given by their offsets
+        template<CSerdes TElementSerdes, CExecutor TExecutor, std::random_access_iterator TOutputIterator, std::ranges::random_access_range TRange>
+        void SerializeBlocks(TExecutor &executor, TOutputIterator bufpos, const TRange &range,
+                             const ParallelBlocks &blocks, const std::vector<uint64_t> &offsets)
+        {
+            const auto first = std::ranges::begin(range);
+
+            executor.Bulk(blocks.count, [&](size_t block)
+            {
+                TOutputIterator out = bufpos + static_cast<std::iter_difference_t<TOutputIterator>>(offsets[block]);
+                for(size_t i = blocks.Begin(block); i < blocks.End(block); i++)
+                    out = TElementSerdes::SerializeTo(out, first[i]);
+            });
+        }
+    }
+
+    /// Serializes a range in parallel; the result is identical to serial serialization
+    /// @tparam TSerdes Range serdes (for example, Vector)
+    /// @param executor Executor running the size computation and the serialization of blocks
+    /// @param bufpos Random access iterator into a buffer of sufficient size
+    /// @param range Random access range of elements
+    /// @return Iterator pointing to the buffer position immediately after the serialized range
+    /// @throw std::length_error if the number of elements exceeds the limit of the size field
+    template<CSerdes TSerdes, CExecutor TExecutor, std::random_access_iterator TOutputIterator, std::ranges::random_access_range TRange>
+    requires details::CRangeSerdes<TSerdes> && COutputIterator<TOutputIterator>
+    TOutputIterator SerializeTo(TExecutor &executor, TOutputIterator bufpos, const TRange &range)
+    {
+        using SizeSerdes = typename TSerdes::SizeSerdes;
+        using ElementSerdes = typename TSerdes::ElementSerdes;
+
+        const size_t size = std::ranges::size(range);
+        if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+            utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+        bufpos = SizeSerdes::SerializeTo(bufpos, size);
+
+        const details::ParallelBlocks blocks(size);
+        const std::vector<uint64_t> offsets = details::BlockOffsets<ElementSerdes>(executor, range, blocks);
+        details::SerializeBlocks<ElementSerdes>(executor, bufpos, range, blocks, offsets);
+
+        return bufpos + static_cast<std::iter_difference_t<TOutputIterator>>(offsets.back());
+    }
+
+    /// Parallel serialization into an automatically created buffer
+    /// @note Element sizes are computed once and used both for the buffer size and the block offsets
+    template<CSerdes TSerdes, CExecutor TExecutor, std::ranges::random_access_range TRange>
+    requires details::CRangeSerdes<TSerdes>
+    [[nodiscard]]
+    std::vector<uint8_t> Serialize(TExecutor &executor, const TRange &range)
+    {
+        using SizeSerdes = typename TSerdes::SizeSerdes;
+        using ElementSerdes = typename TSerdes::ElementSerdes;
+
+        const size_t size = std::ranges::size(range);
+        if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+            utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+        const details::ParallelBlocks blocks(size);
+        const std::vector<uint64_t> offsets = details::BlockOffsets<ElementSerdes>(executor, range, blocks);
+
+        std::vector<uint8_t> buf(SizeSerdes::Sizeof() + offsets.back());
+        auto bufpos = SizeSerdes::SerializeTo(buf.begin(), size);
+        details::SerializeBlocks<ElementSerdes>(executor, bufpos, range, blocks, offsets);
+        return buf;
+    }
+
+    /// Deserializes a chunked sequence in parallel, one chunk per call of the executor
+    /// @tparam TSerdes Chunked serdes (for example, ChunkedVector)
+    /// @param executor Executor running the deserialization of chunks
+    /// @param bufpos Random access iterator pointing to the serialized sequence
+    /// @param sequence Random access container, resized to the number of elements
+    /// @return Iterator pointing to the buffer position immediately after the sequence
+    /// @throw std::runtime_error if the data of a chunk does not match its recorded length
+    template<CSerdes TSerdes, CExecutor TExecutor, std::random_access_iterator TInputIterator, std::ranges::random_access_range TSequence>
+    requires details::CChunkedSerdes<TSerdes> && CInputIterator<TInputIterator>
+    TInputIterator DeserializeFrom(TExecutor &executor, TInputIterator bufpos, TSequence &sequence)
+    {
+        using SizeSerdes = typename TSerdes::SizeSerdes;
+        using ElementSerdes = typename TSerdes::ElementSerdes;
+        constexpr size_t chunkSize = TSerdes::chunkCapacity;
+
+        ValueT<SizeSerdes> size{0};
+        bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+        // Offsets of the chunks relative to the first element
+        const size_t chunks = TSerdes::ChunkCount(size);
+        std::vector<uint64_t> offsets(chunks + 1, 0);
+        for(size_t chunk = 0; chunk < chunks; chunk++)
+        {
+            ValueT<SizeSerdes> length{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, length);
+            offsets[chunk + 1] = offsets[chunk] + length;
+        }
+
+        sequence.resize(size);
+        const auto first = std::ranges::begin(sequence);
+
+        executor.Bulk(chunks, [&](size_t chunk)
+        {
+            using Difference = std::iter_difference_t<TInputIterator>;
+
+            TInputIterator in = bufpos + static_cast<Difference>(offsets[chunk]);
+            auto element = first + static_cast<std::ranges::range_difference_t<TSequence>>(chunk * chunkSize);
+            const size_t count = std::min<size_t>(chunkSize, size - chunk * chunkSize);
+
+            for(size_t i = 0; i < count; i++)
+                in = ElementSerdes::DeserializeFrom(in, *element++);
+
+            if(in != bufpos + static_cast<Difference>(offsets[chunk + 1]))
+                utils::Throw<std::runtime_error>(std::format("length mismatch in chunk {}", chunk));
+        });
+
+        return bufpos + static_cast<std::iter_difference_t<TInputIterator>>(offsets.back());
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -93,6 +93,15 @@ namespace serdes
         }
     };
 
+    //--------------------------------------------------------------------------
+    /// Concept for POD serdes whose serialized form of type T is identical
+    /// to its in-memory representation, so that values can be copied as raw bytes
+    template<typename TSerdes, typename T>
+    concept CRawPod = TSerdes::GetTypeId() == TypeId::Pod
+                      && std::same_as<ValueT<TSerdes>, T>
+                      && requires { { TSerdes::GetEndianness() } -> std::same_as<std::endian>; }
+                      && TSerdes::GetEndianness() == std::endian::native;
+
     //--------------------------------------------------------------------------
     // Mixed-endian architectures are not supported
     static_assert(std::endian::native != std::endian::big || std::endian::native != std::endian::little);
@@ -15,10 +15,12 @@
 */
 //------------------------------------------------------------------------------
 #include <ranges>
+#include <cstring>
 #include "Math.hpp"
 #include "Typeids.hpp"
 #include "Concepts.hpp"
 #include "Helpers.hpp"
+#include "Pod.hpp"
 
 //------------------------------------------------------------------------------
 namespace serdes
@@ -100,11 +102,33 @@ namespace serdes
             // Serialize the range size
             bufpos = SizeSerdes::SerializeTo(bufpos, std::ranges::size(range));
 
-            // Serialize range elements
-            for(const auto &element: range)
-                bufpos = ElementSerdes::SerializeTo(bufpos, element);
+            // Elements whose serialized form is their in-memory representation
+            // are written as a single block when possible
+            if constexpr (std::ranges::contiguous_range<TRange>
+                          && CRawPod<ElementSerdes, std::ranges::range_value_t<TRange>>)
+                if(!std::is_constant_evaluated())
+                {
+                    const auto *data = reinterpret_cast<const uint8_t *>(std::ranges::data(range));
+                    const size_t byteCount = std::ranges::size(range) * sizeof(ElementType);
+
+                    if constexpr (CBlockOutputIterator<TOutputIterator>)
+                        return bufpos.WriteBlock(data, byteCount);
+
+                    else if constexpr (CContiguousByteIterator<TOutputIterator>)
+                    {
+                        if(byteCount)
+                            std::memcpy(std::to_address(bufpos), data, byteCount);
+                        return bufpos + byteCount;
+                    }
+                }
 
-            return bufpos;
+            // Serialize range elements
+            return details::SerializeTransient<details::CTransientElements<TRange>>(bufpos, [&range](TOutputIterator out)
+            {
+                for(const auto &element: range)
+                    out = ElementSerdes::SerializeTo(out, element);
+                return out;
+            });
         }
     };
 
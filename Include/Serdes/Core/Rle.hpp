@@ -0,0 +1,293 @@
+#ifndef SERDES_CORE_RLE_HPP
+#define SERDES_CORE_RLE_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes wrapper storing a sequence with run-length encoding
+
+    @details
+        Flag and status columns keep the same value over long runs of
+        elements. Such sequences are stored as (value, run length) pairs. If
+        the runs are short and the pairs would take more space than the
+        elements, the sequence is stored in the layout of the wrapped
+        sequence serdes, so the result is never more than one byte larger.
+
+        Serialized data format:
+
+            [0][sequence serialized with the sequence serdes]
+
+            or
+
+            [1][n][r][value 1][length 1] ... [value r][length r]
+
+        where the first byte (UInt8) is the mode, n is serialized with the size
+        serdes, the values with the element serdes, and the number of runs r
+        and the run lengths are unsigned varints (see Varint.hpp).
+
+        The deserializer fills the runs with std::fill_n, which the compiler
+        turns into vector stores for contiguous containers of PODs.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <limits>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Varint.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// @tparam TSequenceSerdes Sequence serdes (e.g. Vector<UInt8>) used for the plain layout
+    template<CSerdes TSequenceSerdes>
+    requires details::CRangeSerdes<TSequenceSerdes>
+    struct Rle
+    {
+        /// Serdes of the sequence without the encoding
+        using SequenceSerdes = TSequenceSerdes;
+
+        /// Serdes for serializing/deserializing the number of elements
+        using SizeSerdes = typename SequenceSerdes::SizeSerdes;
+
+        /// Serdes for serializing/deserializing elements
+        using ElementSerdes = typename SequenceSerdes::ElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = ValueT<SequenceSerdes>;
+
+        /// Modes of the serialized data
+        static constexpr uint8_t plainMode = 0;
+        static constexpr uint8_t runMode = 1;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Rle; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        /// The plain layout is chosen whenever the runs would be larger
+        [[nodiscard]] static consteval
+        uint32_t Sizeof() { return utils::Safe<utils::policy::MaxValue>::Add(uint32_t{1}, SequenceSerdes::Sizeof()); }
+
+        /// @note This function may return WRONG_SIZE if an overflow occurs during computation
+        /// or if the range size exceeds the maximum allowed value
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            const uint32_t plainSize = SequenceSerdes::Sizeof(range);
+            if(plainSize == WRONG_SIZE)
+                return WRONG_SIZE;
+
+            return utils::Safe<utils::policy::MaxValue>::Add(uint32_t{1}, std::min(plainSize, RunSize(range)));
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            if(SequenceSerdes::Sizeof(range) <= RunSize(range))
+            {
+                bufpos = Pod<uint8_t>::SerializeTo(bufpos, plainMode);
+                return SequenceSerdes::SerializeTo(bufpos, range);
+            }
+
+            bufpos = Pod<uint8_t>::SerializeTo(bufpos, runMode);
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+            bufpos = details::SerializeVarint(bufpos, CountRuns(range));
+
+            return details::SerializeTransient<details::CTransientElements<TRange>>(bufpos, [&range](TOutputIterator out)
+            {
+                ForEachRun(range, [&out](const auto &value, uint64_t length)
+                {
+                    out = ElementSerdes::SerializeTo(out, value);
+                    out = details::SerializeVarint(out, length);
+                });
+                return out;
+            });
+        }
+
+        /// @throw std::runtime_error if the mode is unknown or the run lengths do not match the number of elements
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            uint8_t mode = 0;
+            bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, mode);
+
+            if(mode == plainMode)
+                return SequenceSerdes::DeserializeFrom(bufpos, sequence);
+            if(mode != runMode)
+                utils::Throw<std::runtime_error>("unknown mode of run-length encoded data");
+
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            uint64_t runs = 0;
+            bufpos = details::DeserializeVarint(bufpos, runs);
+
+            sequence.resize(size);
+            auto element = std::ranges::begin(sequence);
+            uint64_t remaining = size;
+
+            ElementType value{};
+            for(; runs; runs--)
+            {
+                uint64_t length = 0;
+                bufpos = ElementSerdes::DeserializeFrom(bufpos, value);
+                bufpos = details::DeserializeVarint(bufpos, length);
+
+                if(length > remaining)
+                    utils::Throw<std::runtime_error>("run lengths exceed the number of elements");
+
+                element = std::fill_n(element, length, value);
+                remaining -= length;
+            }
+
+            if(remaining)
+                utils::Throw<std::runtime_error>("run lengths do not cover all elements");
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            uint8_t mode = 0;
+            bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, mode);
+            if(mode == plainMode)
+                return serdes::Skip<SequenceSerdes>(bufpos);
+
+            bufpos = details::Advance(bufpos, SizeSerdes::Sizeof());
+
+            uint64_t runs = 0;
+            for(bufpos = details::DeserializeVarint(bufpos, runs); runs; runs--)
+                bufpos = details::SkipVarint(serdes::Skip<ElementSerdes>(bufpos));
+
+            return bufpos;
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder): one run per call
+        /// @throw std::runtime_error if the mode is unknown
+        // Stage 1: the size is next; stage 2: the number of runs is next; stage 3: Count is the number of unscanned runs
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                uint8_t mode = 0;
+                if(!cursor.template Read<Pod<uint8_t>>(mode))
+                    return false;
+
+                if(mode == plainMode)
+                {
+                    cursor.Finish();
+                    cursor.template Then<SequenceSerdes>();
+                    return true;
+                }
+                if(mode != runMode)
+                    utils::Throw<std::runtime_error>("unknown mode of run-length encoded data");
+                cursor.Stage() = 1;
+            }
+
+            if(cursor.Stage() == 1)
+            {
+                ValueT<SizeSerdes> size{0};
+                if(!cursor.template Read<SizeSerdes>(size))
+                    return false;
+                cursor.Stage() = 2;
+            }
+
+            if(cursor.Stage() == 2)
+            {
+                uint64_t runs = 0;
+                if(!cursor.ReadVarint(runs))
+                    return false;
+                cursor.Count() = runs;
+                cursor.Stage() = 3;
+            }
+
+            if(cursor.Count() == 0)
+            {
+                cursor.Finish();
+                return true;
+            }
+
+            cursor.Count()--;
+            cursor.template Then<ElementSerdes>();
+            cursor.Varints(1);
+            return true;
+        }
+
+    private:
+        /// Calls the function with the value and the length of every run
+        template<std::ranges::forward_range TRange, typename TFunction>
+        static constexpr
+        void ForEachRun(const TRange &range, TFunction &&function)
+        {
+            auto first = std::ranges::begin(range);
+            const auto last = std::ranges::end(range);
+
+            while(first != last)
+            {
+                auto next = std::next(first);
+                uint64_t length = 1;
+                for(; next != last && *next == *first; ++next)
+                    length++;
+
+                function(*first, length);
+                first = next;
+            }
+        }
+
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint64_t CountRuns(const TRange &range)
+        {
+            uint64_t runs = 0;
+            ForEachRun(range, [&runs](const auto &, uint64_t) { runs++; });
+            return runs;
+        }
+
+        /// Size of the run layout without the mode byte
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t RunSize(const TRange &range)
+        {
+            uint64_t size = SizeSerdes::Sizeof();
+            uint64_t runs = 0;
+
+            ForEachRun(range, [&size, &runs](const auto &value, uint64_t length)
+            {
+                size += ElementSerdes::Sizeof(value) + details::VarintSize(length);
+                runs++;
+            });
+
+            size += details::VarintSize(runs);
+            return size < WRONG_SIZE ? static_cast<uint32_t>(size) : WRONG_SIZE;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
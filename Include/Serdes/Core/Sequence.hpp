@@ -14,10 +14,12 @@
 */
 //------------------------------------------------------------------------------
 #include <ranges>
+#include <cstring>
 #include "Math.hpp"
 #include "Typeids.hpp"
 #include "Concepts.hpp"
 #include "Helpers.hpp"
+#include "Pod.hpp"
 #include "Range.hpp"
 
 //------------------------------------------------------------------------------
@@ -46,10 +48,30 @@ namespace serdes
 
             sequence.resize(sequenceSize);
 
+            // Contiguous buffer and container: elements are copied as a single block
+            if constexpr (CContiguousByteIterator<TInputIterator>
+                          && std::ranges::contiguous_range<TSequence>
+                          && CRawPod<TElementSerdes, std::ranges::range_value_t<TSequence>>)
+                if(!std::is_constant_evaluated())
+                {
+                    const size_t byteCount = sequenceSize * sizeof(ValueT<TElementSerdes>);
+                    if(byteCount)
+                        std::memcpy(std::ranges::data(sequence), std::to_address(bufpos), byteCount);
+                    return bufpos + byteCount;
+                }
+
             // Deserialize elements
             auto element = std::ranges::begin(sequence);
             for(size_t i = 0; i < sequenceSize; i++)
-                bufpos = TElementSerdes::DeserializeFrom(bufpos, *element++);
+                if constexpr (std::is_lvalue_reference_v<std::ranges::range_reference_t<TSequence>>)
+                    bufpos = TElementSerdes::DeserializeFrom(bufpos, *element++);
+                else
+                {
+                    // Proxy references (std::vector<bool>) are assigned a deserialized value
+                    ValueT<TElementSerdes> value{};
+                    bufpos = TElementSerdes::DeserializeFrom(bufpos, value);
+                    *element++ = std::move(value);
+                }
 
             return bufpos;
         }
@@ -0,0 +1,332 @@
+#ifndef SERDES_CORE_SHUFFLED_HPP
+#define SERDES_CORE_SHUFFLED_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes wrapper storing a sequence of multi-byte POD values with shuffled bytes
+
+    @details
+        The byte shuffle transform (as in Blosc) stores the first bytes of all
+        elements, then the second bytes of all elements, and so on. The size
+        of the data is unchanged, but the high bytes of numbers of similar
+        magnitude and the sign/exponent bytes of floating-point values form
+        long runs of equal or similar bytes, so general-purpose compression of
+        the result is much more effective.
+
+        Serialized data format:
+
+            [n][byte 0 of elements 1..n][byte 1 of elements 1..n] ... [byte w-1 of elements 1..n]
+
+        where w is the size of an element. Byte k of an element is byte k of
+        its representation produced by the element serdes, so the byte order of
+        the element serdes is respected.
+
+        The transform is performed by SSE2 or AVX2 kernels when the code is
+        compiled with support for them, otherwise by a scalar loop.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <ranges>
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "Pod.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+#if defined(__AVX2__)
+        using ShuffleVector = __m256i;
+
+        inline ShuffleVector ShuffleLoad(const uint8_t *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+        inline void ShuffleStore(uint8_t *p, ShuffleVector v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+
+        /// Even and odd bytes of two vectors; packing works within 128-bit lanes,
+        /// the permutation restores the order of the 64-bit parts
+        inline void SplitBytes(ShuffleVector a, ShuffleVector b, ShuffleVector &even, ShuffleVector &odd) noexcept
+        {
+            const __m256i mask = _mm256_set1_epi16(0x00FF);
+            even = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask)), 0xD8);
+            odd = _mm256_permute4x64_epi64(_mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8)), 0xD8);
+        }
+
+        /// Interleaves the bytes of two vectors (the inverse of SplitBytes)
+        inline void MergeBytes(ShuffleVector even, ShuffleVector odd, ShuffleVector &a, ShuffleVector &b) noexcept
+        {
+            const __m256i low = _mm256_unpacklo_epi8(even, odd);
+            const __m256i high = _mm256_unpackhi_epi8(even, odd);
+            a = _mm256_permute2x128_si256(low, high, 0x20);
+            b = _mm256_permute2x128_si256(low, high, 0x31);
+        }
+#elif defined(__SSE2__)
+        using ShuffleVector = __m128i;
+
+        inline ShuffleVector ShuffleLoad(const uint8_t *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+        inline void ShuffleStore(uint8_t *p, ShuffleVector v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+        /// Even and odd bytes of two vectors
+        inline void SplitBytes(ShuffleVector a, ShuffleVector b, ShuffleVector &even, ShuffleVector &odd) noexcept
+        {
+            const __m128i mask = _mm_set1_epi16(0x00FF);
+            even = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+            odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        }
+
+        /// Interleaves the bytes of two vectors (the inverse of SplitBytes)
+        inline void MergeBytes(ShuffleVector even, ShuffleVector odd, ShuffleVector &a, ShuffleVector &b) noexcept
+        {
+            a = _mm_unpacklo_epi8(even, odd);
+            b = _mm_unpackhi_epi8(even, odd);
+        }
+#endif
+
+        /// Transposes n elements of width bytes: byte k of element i is moved to position k * n + i
+        template<size_t width>
+        constexpr
+        void ShuffleBytes(const uint8_t *src, uint8_t *dst, size_t n) noexcept
+        {
+            size_t first = 0;
+
+#if defined(__SSE2__)
+            // A block of sizeof(ShuffleVector) elements is loaded into width vectors. Each round splits
+            // pairs of vectors into even and odd bytes, placing all even parts before the odd parts;
+            // after log2(width) rounds vector k holds byte k of the elements.
+            if(!std::is_constant_evaluated())
+            {
+                constexpr size_t lanes = sizeof(ShuffleVector);
+                for(; first + lanes <= n; first += lanes)
+                {
+                    ShuffleVector v[width], next[width];
+                    for(size_t k = 0; k < width; k++)
+                        v[k] = ShuffleLoad(src + (first + k * lanes / width) * width);
+
+                    for(size_t round = 1; round < width; round *= 2)
+                    {
+                        for(size_t k = 0; k < width / 2; k++)
+                            SplitBytes(v[2 * k], v[2 * k + 1], next[k], next[k + width / 2]);
+                        std::copy(next, next + width, v);
+                    }
+
+                    for(size_t k = 0; k < width; k++)
+                        ShuffleStore(dst + k * n + first, v[k]);
+                }
+            }
+#endif
+
+            for(size_t i = first; i < n; i++)
+                for(size_t k = 0; k < width; k++)
+                    dst[k * n + i] = src[i * width + k];
+        }
+
+        /// Inverse of ShuffleBytes
+        template<size_t width>
+        constexpr
+        void UnshuffleBytes(const uint8_t *src, uint8_t *dst, size_t n) noexcept
+        {
+            size_t first = 0;
+
+#if defined(__SSE2__)
+            if(!std::is_constant_evaluated())
+            {
+                constexpr size_t lanes = sizeof(ShuffleVector);
+                for(; first + lanes <= n; first += lanes)
+                {
+                    ShuffleVector v[width], next[width];
+                    for(size_t k = 0; k < width; k++)
+                        v[k] = ShuffleLoad(src + k * n + first);
+
+                    for(size_t round = 1; round < width; round *= 2)
+                    {
+                        for(size_t k = 0; k < width / 2; k++)
+                            MergeBytes(v[k], v[k + width / 2], next[2 * k], next[2 * k + 1]);
+                        std::copy(next, next + width, v);
+                    }
+
+                    for(size_t k = 0; k < width; k++)
+                        ShuffleStore(dst + (first + k * lanes / width) * width, v[k]);
+                }
+            }
+#endif
+
+            for(size_t i = first; i < n; i++)
+                for(size_t k = 0; k < width; k++)
+                    dst[i * width + k] = src[k * n + i];
+        }
+
+        /// Sequence serdes whose elements can be shuffled
+        template<typename TSerdes>
+        concept CShuffleableSerdes = requires
+        {
+            typename TSerdes::SizeSerdes;
+            typename TSerdes::ElementSerdes;
+        } && (TSerdes::GetTypeId() == TypeId::Range)
+          && (TSerdes::ElementSerdes::GetTypeId() == TypeId::Pod)
+          && (TSerdes::ElementSerdes::Sizeof() == 2 || TSerdes::ElementSerdes::Sizeof() == 4
+              || TSerdes::ElementSerdes::Sizeof() == 8);
+    }
+
+    /// @tparam TSequenceSerdes Sequence serdes (e.g. Vector<Double>) with 2, 4 or 8-byte POD elements
+    template<CSerdes TSequenceSerdes>
+    requires details::CShuffleableSerdes<TSequenceSerdes>
+    struct Shuffled
+    {
+        /// Serdes of the sequence without the transform
+        using SequenceSerdes = TSequenceSerdes;
+
+        /// Serdes for serializing/deserializing the number of elements
+        using SizeSerdes = typename SequenceSerdes::SizeSerdes;
+
+        /// Serdes for serializing/deserializing elements
+        using ElementSerdes = typename SequenceSerdes::ElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = ValueT<SequenceSerdes>;
+
+        /// Size of an element (in bytes)
+        static constexpr size_t elementSize = ElementSerdes::Sizeof();
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Shuffled; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof() { return SequenceSerdes::Sizeof(); }
+
+        /// @note This function may return WRONG_SIZE if the size or the range size exceeds the allowed limit
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range) { return SequenceSerdes::Sizeof(range); }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+
+            // Elements stored in memory in the serialized form are shuffled directly
+            if constexpr (std::ranges::contiguous_range<TRange>
+                          && CRawPod<ElementSerdes, std::ranges::range_value_t<TRange>>)
+                if(!std::is_constant_evaluated())
+                {
+                    const auto *data = reinterpret_cast<const uint8_t *>(std::ranges::data(range));
+                    const size_t byteCount = size * elementSize;
+
+                    if constexpr (CContiguousByteIterator<TOutputIterator>)
+                    {
+                        details::ShuffleBytes<elementSize>(data, reinterpret_cast<uint8_t *>(std::to_address(bufpos)), size);
+                        return bufpos + byteCount;
+                    }
+                    else
+                    {
+                        std::vector<uint8_t> shuffled(byteCount);
+                        details::ShuffleBytes<elementSize>(data, shuffled.data(), size);
+
+                        // The local buffer is written through an iterator that copies blocks
+                        if constexpr (CBlockOutputIterator<TOutputIterator>)
+                            return details::SerializeTransient(bufpos, [&shuffled](TOutputIterator out)
+                            {
+                                return out.WriteBlock(shuffled.data(), shuffled.size());
+                            });
+                        else
+                            return std::copy(shuffled.begin(), shuffled.end(), bufpos);
+                    }
+                }
+
+            // Otherwise byte k of every element is written in pass k
+            for(size_t k = 0; k < elementSize; k++)
+                for(const auto &element: range)
+                {
+                    std::array<uint8_t, elementSize> bytes;
+                    ElementSerdes::SerializeTo(bytes.begin(), element);
+                    *bufpos++ = bytes[k];
+                }
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            sequence.resize(size);
+            const size_t byteCount = size * elementSize;
+
+            // Contiguous buffer and container: the bytes are restored in place
+            if constexpr (CContiguousByteIterator<TInputIterator>
+                          && std::ranges::contiguous_range<TSequence>
+                          && CRawPod<ElementSerdes, std::ranges::range_value_t<TSequence>>)
+                if(!std::is_constant_evaluated())
+                {
+                    details::UnshuffleBytes<elementSize>(reinterpret_cast<const uint8_t *>(std::to_address(bufpos)),
+                                                         reinterpret_cast<uint8_t *>(std::ranges::data(sequence)), size);
+                    return bufpos + byteCount;
+                }
+
+            std::vector<uint8_t> shuffled(byteCount), bytes(byteCount);
+            for(uint8_t &byte: shuffled)
+                byte = static_cast<uint8_t>(*bufpos++);
+            details::UnshuffleBytes<elementSize>(shuffled.data(), bytes.data(), size);
+
+            auto element = std::ranges::begin(sequence);
+            for(auto pos = bytes.cbegin(); pos != bytes.cend(); )
+                pos = ElementSerdes::DeserializeFrom(pos, *element++);
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            return details::Advance(bufpos, static_cast<uint64_t>(size) * elementSize);
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            ValueT<SizeSerdes> size{0};
+            if(!cursor.template Read<SizeSerdes>(size))
+                return false;
+
+            cursor.Finish();
+            cursor.Bytes(static_cast<uint64_t>(size) * elementSize);
+            return true;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,156 @@
+#ifndef SERDES_CORE_SKIP_HPP
+#define SERDES_CORE_SKIP_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Skipping serialized values without deserializing them
+
+    @details
+        Skip advances a buffer iterator past a serialized value. Values of serdes
+        with a static buffer are skipped in a single step; for composite serdes only
+        the structural fields (range sizes, variant indices, pointer flags) are read.
+
+        A serdes with its own data format may provide a static member function
+        Skip(bufpos), which takes precedence over the generic traversal.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <iterator>
+#include <tuple>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Pod.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Serdes defining its own skip function
+        template<typename TSerdes, typename TInputIterator>
+        concept CSkippable = requires(TInputIterator bufpos)
+        {
+            { TSerdes::Skip(bufpos) } -> std::same_as<TInputIterator>;
+        };
+
+        /// Serdes based on another serdes (Struct, Custom)
+        template<typename TSerdes>
+        concept CBasedSerdes = requires { typename TSerdes::BaseSerdes; };
+
+        /// Serdes with a list of nested serdes (Tuple, Variant, Pointer)
+        template<typename TSerdes>
+        concept CListSerdes = requires { typename TSerdes::SerdesList; };
+
+        /// Serdes for ranges (Sequence, Assoc, String)
+        template<typename TSerdes>
+        concept CRangeSerdes = requires
+        {
+            typename TSerdes::SizeSerdes;
+            typename TSerdes::ElementSerdes;
+        } && (TSerdes::GetTypeId() == TypeId::Range);
+
+        /// Serdes for fixed-size arrays
+        template<typename TSerdes>
+        concept CArraySerdes = requires
+        {
+            typename TSerdes::ElementSerdes;
+            TSerdes::arraySize;
+        } && (TSerdes::GetTypeId() == TypeId::Array);
+
+        /// Serdes accessing a value through a pointer without a null flag (Reference)
+        template<typename TSerdes>
+        concept CIndirectSerdes = requires { typename TSerdes::SerdesType; };
+
+        template<typename T>
+        inline constexpr bool dependentFalse = false;
+
+        template<typename TInputIterator>
+        constexpr
+        TInputIterator Advance(TInputIterator bufpos, uint64_t n)
+        {
+            std::advance(bufpos, static_cast<std::iter_difference_t<TInputIterator>>(n));
+            return bufpos;
+        }
+    }
+
+    /// Skips a serialized value
+    /// @tparam TSerdes Pack of serdes used to serialize the value
+    /// @param bufpos Iterator pointing to the serialized value
+    /// @return Iterator pointing to the buffer position immediately after the value
+    /// @note This function does not perform bounds checking.
+    template<CSerdes ...TSerdes, CInputIterator TInputIterator>
+    constexpr
+    TInputIterator Skip(TInputIterator bufpos)
+    {
+        using SkipSerdes = SerdesT<TSerdes...>;
+
+        if constexpr (details::CSkippable<SkipSerdes, TInputIterator>)
+            return SkipSerdes::Skip(bufpos);
+
+        else if constexpr (SkipSerdes::GetBufferType() == BufferType::Static)
+            return details::Advance(bufpos, SkipSerdes::Sizeof());
+
+        else if constexpr (details::CBasedSerdes<SkipSerdes>)
+            return Skip<typename SkipSerdes::BaseSerdes>(bufpos);
+
+        else if constexpr (details::CListSerdes<SkipSerdes> && SkipSerdes::GetTypeId() == TypeId::Variant)
+        {
+            // Variant and Pointer: the index of the serialized alternative precedes the value
+            uint8_t index;
+            bufpos = Pod<uint8_t>::DeserializeFrom(bufpos, index);
+
+            return [index]<size_t ...I>(TInputIterator bufpos, std::index_sequence<I...>) constexpr
+            {
+                ((void)((index == I ? (bufpos = Skip<std::tuple_element_t<I, typename SkipSerdes::SerdesList>>(bufpos), false) : true) && ...));
+                return bufpos;
+            }(bufpos, std::make_index_sequence<std::tuple_size_v<typename SkipSerdes::SerdesList>>{});
+        }
+
+        else if constexpr (details::CListSerdes<SkipSerdes> && SkipSerdes::GetTypeId() == TypeId::Tuple)
+        {
+            return []<typename ...TElementSerdes>(TInputIterator bufpos, std::tuple<TElementSerdes...> *) constexpr
+            {
+                ((bufpos = Skip<TElementSerdes>(bufpos)), ...);
+                return bufpos;
+            }(bufpos, static_cast<typename SkipSerdes::SerdesList *>(nullptr));
+        }
+
+        else if constexpr (details::CRangeSerdes<SkipSerdes>)
+        {
+            using ElementSerdes = typename SkipSerdes::ElementSerdes;
+
+            ValueT<typename SkipSerdes::SizeSerdes> size{0};
+            bufpos = SkipSerdes::SizeSerdes::DeserializeFrom(bufpos, size);
+
+            if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                return details::Advance(bufpos, static_cast<uint64_t>(size) * ElementSerdes::Sizeof());
+            else
+            {
+                for(uint32_t i = 0; i < size; i++)
+                    bufpos = Skip<ElementSerdes>(bufpos);
+                return bufpos;
+            }
+        }
+
+        else if constexpr (details::CArraySerdes<SkipSerdes>)
+        {
+            for(uint32_t i = 0; i < SkipSerdes::arraySize; i++)
+                bufpos = Skip<typename SkipSerdes::ElementSerdes>(bufpos);
+            return bufpos;
+        }
+
+        else if constexpr (details::CIndirectSerdes<SkipSerdes>)
+            return Skip<typename SkipSerdes::SerdesType>(bufpos);
+
+        else
+            static_assert(details::dependentFalse<SkipSerdes>, "Skip: the serdes layout is unknown, define TSerdes::Skip(bufpos)");
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,244 @@
+#ifndef SERDES_CORE_STREAM_HPP
+#define SERDES_CORE_STREAM_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for streaming serialization of ranges of unknown size
+
+    @details
+        Unlike Range, the Stream serdes does not require the number of elements
+        in advance, so input ranges (generators, std::views::istream, filtered views)
+        are serialized directly, in bounded memory.
+
+        Serialized data format: a sequence of chunks, each consisting of the number
+        of elements in the chunk (at most chunkSize) followed by the elements,
+        terminated by a chunk with zero elements:
+
+            [n1][e1 ... en1][n2][e1 ... en2] ... [0]
+
+        The format does not depend on the output iterator. If the iterator is
+        a forward iterator (a seekable buffer), the element count of a chunk is
+        back-patched after its elements are written; otherwise the serialized
+        elements of a chunk are staged in a temporary buffer.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <vector>
+#include <iterator>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements in a chunk
+    /// @tparam TElementSerdes Serdes used to serialize/deserialize individual elements
+    /// @tparam TValueType Container type used for deserialization
+    /// @tparam chunkSize Maximum number of elements in a chunk
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType,
+        uint32_t chunkSize = 4096>
+    requires ((TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+              && chunkSize > 0 && chunkSize <= std::numeric_limits<ValueT<TSizeSerdes>>::max())
+    struct Stream
+    {
+        /// Serdes for serializing/deserializing chunk sizes
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing elements
+        using ElementSerdes = TElementSerdes;
+
+        using ValueType = TValueType;
+
+        /// Maximum number of elements in a chunk
+        static constexpr uint32_t chunkCapacity = chunkSize;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Stream; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        /// The number of elements is unbounded
+        [[nodiscard]] static consteval
+        uint32_t Sizeof() { return WRONG_SIZE; }
+
+        /// @note This function may return WRONG_SIZE if an overflow occurs during computation
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            if constexpr (std::ranges::forward_range<const TRange>)
+                return SizeofChunks(range);
+            else
+            {
+                TRange view = range;
+                return SizeofChunks(view);
+            }
+        }
+
+        /// Serializes a range, which may be an input range without a known size
+        /// @note Ranges that can be iterated only through a non-const object
+        /// (for example, std::views::istream) are iterated through a copy of the view.
+        template<COutputIterator TOutputIterator, std::ranges::input_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            if constexpr (std::ranges::input_range<const TRange>)
+                return SerializeChunks(bufpos, range);
+            else
+            {
+                static_assert(std::copyable<TRange>, "Stream: the range cannot be iterated");
+                TRange view = range;
+                return SerializeChunks(bufpos, view);
+            }
+        }
+
+        /// Deserializes into a sequential container, appending the elements chunk by chunk
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            sequence.clear();
+
+            while(true)
+            {
+                ValueT<SizeSerdes> count{0};
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, count);
+                if(count == 0)
+                    return bufpos;
+
+                if constexpr (std::ranges::random_access_range<TSequence>)
+                {
+                    const size_t offset = std::ranges::size(sequence);
+                    sequence.resize(offset + count);
+                    auto element = std::ranges::begin(sequence) + offset;
+                    for(size_t i = 0; i < count; i++)
+                        bufpos = ElementSerdes::DeserializeFrom(bufpos, *element++);
+                }
+                else
+                    for(size_t i = 0; i < count; i++)
+                        bufpos = ElementSerdes::DeserializeFrom(bufpos, sequence.emplace_back());
+            }
+        }
+
+        /// Skips a serialized value
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            while(true)
+            {
+                ValueT<SizeSerdes> count{0};
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, count);
+                if(count == 0)
+                    return bufpos;
+
+                if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                    bufpos = details::Advance(bufpos, static_cast<uint64_t>(count) * ElementSerdes::Sizeof());
+                else
+                    for(size_t i = 0; i < count; i++)
+                        bufpos = serdes::Skip<ElementSerdes>(bufpos);
+            }
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder): one chunk per call
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            ValueT<SizeSerdes> count{0};
+            if(!cursor.template Read<SizeSerdes>(count))
+                return false;
+
+            if(count == 0)
+                cursor.Finish();
+            else
+                cursor.template Then<ElementSerdes>(count);
+            return true;
+        }
+
+    private:
+        template<typename TRange>
+        static constexpr
+        uint32_t SizeofChunks(TRange &range)
+        {
+            using Safe = utils::Safe<utils::policy::MaxValue>;
+
+            uint32_t count = 0;
+            uint32_t bufSize = 0;
+            for(const auto &element: range)
+            {
+                count++;
+                if constexpr (ElementSerdes::GetBufferType() == BufferType::Static)
+                    bufSize = Safe::Add(bufSize, ElementSerdes::Sizeof());
+                else
+                    bufSize = Safe::Add(bufSize, ElementSerdes::Sizeof(element));
+            }
+
+            // Chunk sizes, including the terminating zero size
+            const uint32_t chunks = count / chunkSize + (count % chunkSize != 0) + 1;
+            return Safe::Add(bufSize, Safe::Mul(chunks, SizeSerdes::Sizeof()));
+        }
+
+        template<COutputIterator TOutputIterator, typename TRange>
+        static constexpr
+        TOutputIterator SerializeChunks(TOutputIterator bufpos, TRange &range)
+        {
+            auto element = std::ranges::begin(range);
+            const auto end = std::ranges::end(range);
+
+            if constexpr (std::forward_iterator<TOutputIterator>)
+            {
+                // The chunk size is written after the chunk elements
+                while(true)
+                {
+                    TOutputIterator countPos = bufpos;
+                    bufpos = SizeSerdes::SerializeTo(bufpos, 0);
+
+                    uint32_t count = 0;
+                    for(; count < chunkSize && element != end; ++element, ++count)
+                        bufpos = ElementSerdes::SerializeTo(bufpos, *element);
+
+                    if(count == 0)
+                        return bufpos;
+
+                    SizeSerdes::SerializeTo(countPos, count);
+                }
+            }
+            else
+            {
+                // The chunk elements are staged until the chunk size is known
+                std::vector<uint8_t> chunk;
+                while(true)
+                {
+                    chunk.clear();
+
+                    uint32_t count = 0;
+                    for(; count < chunkSize && element != end; ++element, ++count)
+                        ElementSerdes::SerializeTo(std::back_inserter(chunk), *element);
+
+                    bufpos = SizeSerdes::SerializeTo(bufpos, count);
+                    if(count == 0)
+                        return bufpos;
+
+                    for(uint8_t byte: chunk)
+                        *bufpos++ = byte;
+                }
+            }
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -9,20 +9,101 @@
         The main functions of the Tuple serdes have overloaded versions
         that accept tuple elements as a parameter pack.
 
+        Consecutive bit fields (see BitField.hpp) form a group packed into
+        ceil(bits / 8) bytes at the position of the group, starting from the
+        least significant bit of the first byte. A group holds up to 64 bits;
+        the next bit field that does not fit starts a new group. Offsets of
+        the fields and sizes of the groups are computed at compile time, and
+        a tuple of static serdes remains static.
+
     @todo
 
     @author Niraleks
 */
 //------------------------------------------------------------------------------
+#include <array>
 #include <tuple>
+#include <utility>
 #include "Math.hpp"
 #include "Typeids.hpp"
 #include "Concepts.hpp"
 #include "Helpers.hpp"
+#include "BitField.hpp"
+#include "Skip.hpp"
 
 //------------------------------------------------------------------------------
 namespace serdes
 {
+    namespace details
+    {
+        /// Position of a tuple element in the serialized tuple
+        struct TupleField
+        {
+            /// The element is a bit field packed into a group
+            bool packed = false;
+
+            /// The element is the first/last bit field of its group
+            bool first = false;
+            bool last = false;
+
+            /// Offset of the bit field in its group (in bits)
+            unsigned offset = 0;
+
+            /// Size of the group (in bytes)
+            unsigned groupBytes = 0;
+        };
+
+        template<typename TSerdes>
+        consteval
+        unsigned PackedBits()
+        {
+            if constexpr (CBitFieldSerdes<TSerdes>)
+                return TSerdes::bitCount;
+            else
+                return 0;
+        }
+
+        /// Computes the positions of tuple elements
+        template<typename ...TSerdes>
+        consteval
+        std::array<TupleField, sizeof...(TSerdes)> TupleLayout()
+        {
+            constexpr std::array<unsigned, sizeof...(TSerdes)> bits{PackedBits<TSerdes>()...};
+            std::array<TupleField, sizeof...(TSerdes)> layout{};
+
+            size_t groupStart = 0;
+            unsigned groupBits = 0;
+
+            const auto closeGroup = [&](size_t end)
+            {
+                if(groupBits == 0)
+                    return;
+                for(size_t i = groupStart; i < end; i++)
+                    layout[i].groupBytes = (groupBits + 7) / 8;
+                layout[groupStart].first = true;
+                layout[end - 1].last = true;
+                groupBits = 0;
+            };
+
+            for(size_t i = 0; i < bits.size(); i++)
+            {
+                if(bits[i] == 0 || groupBits + bits[i] > 64)
+                    closeGroup(i);
+                if(bits[i] == 0)
+                    continue;
+
+                if(groupBits == 0)
+                    groupStart = i;
+                layout[i].packed = true;
+                layout[i].offset = groupBits;
+                groupBits += bits[i];
+            }
+            closeGroup(bits.size());
+
+            return layout;
+        }
+    }
+
     /// @tparam TSerdes Pack of serdes for tuple elements
     template<CSerdes ...TSerdes>
     struct Tuple
@@ -32,6 +113,12 @@ namespace serdes
         /// Type defining the list of serdes for tuple elements
         using SerdesList = std::tuple<TSerdes...>;
 
+        /// Some elements are bit fields packed into groups
+        static constexpr bool hasBitFields = (details::CBitFieldSerdes<TSerdes> || ...);
+
+        /// Positions of the elements
+        static constexpr std::array<details::TupleField, sizeof...(TSerdes)> fieldLayout = details::TupleLayout<TSerdes...>();
+
         static consteval
         TypeId GetTypeId() { return TypeId::Tuple; }
 
@@ -45,7 +132,13 @@ namespace serdes
         uint32_t Sizeof()
         {
             uint32_t n = 0;
-            ((n = utils::Safe<utils::policy::MaxValue>::Add(TSerdes::Sizeof(), n)), ...);
+            if constexpr (hasBitFields)
+                [&n]<size_t ...I>(std::index_sequence<I...>)
+                {
+                    ((n = utils::Safe<utils::policy::MaxValue>::Add(FieldSize<I>(TSerdes::Sizeof()), n)), ...);
+                }(std::index_sequence_for<TSerdes...>{});
+            else
+                ((n = utils::Safe<utils::policy::MaxValue>::Add(TSerdes::Sizeof(), n)), ...);
             return n;
         }
 
@@ -58,12 +151,7 @@ namespace serdes
         [[nodiscard]] static constexpr
         uint32_t Sizeof(const TValue &tpl)
         {
-            return std::apply([](auto &...values)
-            {
-                uint32_t valueSize = 0;
-                ((valueSize = utils::Safe<utils::policy::MaxValue>::Add(TSerdes::Sizeof(values), valueSize)), ...);
-                return valueSize;
-            }, tpl);
+            return std::apply([](auto &...values) { return Sizeof(values...); }, tpl);
         }
 
         template<typename... TValues>
@@ -72,7 +160,13 @@ namespace serdes
         uint32_t Sizeof(const TValues &...values)
         {
             uint32_t valueSize = 0;
-            ((valueSize = utils::Safe<utils::policy::MaxValue>::Add(TSerdes::Sizeof(values), valueSize)), ...);
+            if constexpr (hasBitFields)
+                [&]<size_t ...I>(std::index_sequence<I...>)
+                {
+                    ((valueSize = utils::Safe<utils::policy::MaxValue>::Add(FieldSize<I>(TSerdes::Sizeof(values)), valueSize)), ...);
+                }(std::index_sequence_for<TSerdes...>{});
+            else
+                ((valueSize = utils::Safe<utils::policy::MaxValue>::Add(TSerdes::Sizeof(values), valueSize)), ...);
             return valueSize;
         }
 
@@ -83,7 +177,7 @@ namespace serdes
         {
             std::apply([&bufpos](const auto &...values)
             {
-                ((bufpos = TSerdes::SerializeTo(bufpos, values)), ...);
+                bufpos = SerializeTo(bufpos, values...);
             }, value);
 
             return bufpos;
@@ -103,7 +197,17 @@ namespace serdes
         static constexpr
         TOutputIterator SerializeTo(TOutputIterator bufpos, const TValues &...values)
         {
-            ((bufpos = TSerdes::SerializeTo(bufpos, values)), ...);
+            if constexpr (hasBitFields)
+            {
+                // Bit fields are accumulated in the word, which is written after the last field of the group
+                uint64_t word = 0;
+                [&]<size_t ...I>(std::index_sequence<I...>)
+                {
+                    (SerializeField<I, TSerdes>(bufpos, word, values), ...);
+                }(std::index_sequence_for<TSerdes...>{});
+            }
+            else
+                ((bufpos = TSerdes::SerializeTo(bufpos, values)), ...);
             return bufpos;
         }
 
@@ -114,7 +218,7 @@ namespace serdes
         {
             std::apply([&bufpos](auto &...values)
             {
-                ((bufpos = TSerdes::DeserializeFrom(bufpos, values)), ...);
+                bufpos = DeserializeFrom(bufpos, values...);
             }, tpl);
             return bufpos;
         }
@@ -124,9 +228,117 @@ namespace serdes
         static constexpr
         TInputIterator DeserializeFrom(TInputIterator bufpos, TValues &...values)
         {
-            ((bufpos = TSerdes::DeserializeFrom(bufpos, values)), ...);
+            if constexpr (hasBitFields)
+            {
+                // The word of a group is read at the first field of the group
+                uint64_t word = 0;
+                [&]<size_t ...I>(std::index_sequence<I...>)
+                {
+                    (DeserializeField<I, TSerdes>(bufpos, word, values), ...);
+                }(std::index_sequence_for<TSerdes...>{});
+            }
+            else
+                ((bufpos = TSerdes::DeserializeFrom(bufpos, values)), ...);
             return bufpos;
         }
+
+        /// Skips a tuple with a dynamic buffer containing bit fields
+        /// (static tuples are skipped in a single step)
+        template<CInputIterator TInputIterator>
+        requires (hasBitFields && ((TSerdes::GetBufferType() == BufferType::Dynamic) || ...))
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            [&bufpos]<size_t ...I>(std::index_sequence<I...>)
+            {
+                ((bufpos = SkipField<I, TSerdes>(bufpos)), ...);
+            }(std::index_sequence_for<TSerdes...>{});
+            return bufpos;
+        }
+
+        /// Scans a tuple with a dynamic buffer containing bit fields, received in fragments
+        /// (see IncrementalDecoder): the elements and the groups are scheduled in order
+        template<typename TCursor>
+        requires (hasBitFields && ((TSerdes::GetBufferType() == BufferType::Dynamic) || ...))
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            cursor.Finish();
+            [&cursor]<size_t ...I>(std::index_sequence<I...>)
+            {
+                (ScanField<I, TSerdes>(cursor), ...);
+            }(std::index_sequence_for<TSerdes...>{});
+            return true;
+        }
+
+    private:
+        /// Size of an element: the size of the group for the last field of a group, 0 for other bit fields
+        template<size_t index>
+        [[nodiscard]] static constexpr
+        uint32_t FieldSize(uint32_t elementSize)
+        {
+            if constexpr (fieldLayout[index].packed)
+                return fieldLayout[index].last ? fieldLayout[index].groupBytes : 0;
+            else
+                return elementSize;
+        }
+
+        template<size_t index, typename TElementSerdes, COutputIterator TOutputIterator, typename TValue>
+        static constexpr
+        void SerializeField(TOutputIterator &bufpos, uint64_t &word, const TValue &value)
+        {
+            constexpr details::TupleField field = fieldLayout[index];
+            if constexpr (!field.packed)
+                bufpos = TElementSerdes::SerializeTo(bufpos, value);
+            else
+            {
+                word |= TElementSerdes::ToBits(value) << field.offset;
+                if constexpr (field.last)
+                {
+                    bufpos = details::SerializeBitWord(bufpos, word, field.groupBytes);
+                    word = 0;
+                }
+            }
+        }
+
+        template<size_t index, typename TElementSerdes, CInputIterator TInputIterator, typename TValue>
+        static constexpr
+        void DeserializeField(TInputIterator &bufpos, uint64_t &word, TValue &value)
+        {
+            constexpr details::TupleField field = fieldLayout[index];
+            if constexpr (!field.packed)
+                bufpos = TElementSerdes::DeserializeFrom(bufpos, value);
+            else
+            {
+                if constexpr (field.first)
+                    bufpos = details::DeserializeBitWord(bufpos, word, field.groupBytes);
+                value = TElementSerdes::FromBits(word >> field.offset);
+            }
+        }
+
+        template<size_t index, typename TElementSerdes, CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator SkipField(TInputIterator bufpos)
+        {
+            constexpr details::TupleField field = fieldLayout[index];
+            if constexpr (!field.packed)
+                return serdes::Skip<TElementSerdes>(bufpos);
+            else if constexpr (field.last)
+                return details::Advance(bufpos, field.groupBytes);
+            else
+                return bufpos;
+        }
+
+        template<size_t index, typename TElementSerdes, typename TCursor>
+        static constexpr
+        void ScanField(TCursor &cursor)
+        {
+            constexpr details::TupleField field = fieldLayout[index];
+            if constexpr (!field.packed)
+                cursor.template Then<TElementSerdes>();
+            else if constexpr (field.last)
+                cursor.Bytes(field.groupBytes);
+        }
     };
 
 } // namespace serdes
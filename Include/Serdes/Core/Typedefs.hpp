@@ -38,6 +38,7 @@
 #include "Sequence.hpp"
 #include "Assoc.hpp"
 #include "String.hpp"
+#include "BitField.hpp"
 #include "Tuple.hpp"
 #include "Array.hpp"
 #include "Variant.hpp"
@@ -45,6 +46,18 @@
 #include "Reference.hpp"
 #include "Struct.hpp"
 #include "Custom.hpp"
+#include "Stream.hpp"
+#include "Chunked.hpp"
+#include "Varint.hpp"
+#include "Delta.hpp"
+#include "XorFloat.hpp"
+#include "Shuffled.hpp"
+#include "Compressed.hpp"
+#include "Dict.hpp"
+#include "Rle.hpp"
+#include "BitVector.hpp"
+#include "Packed.hpp"
+#include "Decimal.hpp"
 
 
 //-----------------------------------------------------------------------------
@@ -96,6 +109,13 @@ namespace serdes
     using Double = Pod<double, PodTypeId::Double>;
     using DoubleB = Pod<double, PodTypeId::DoubleB>;
 
+    //--------------------------------------------------------------------------
+    // Bit fields packed with the neighbouring bit fields inside tuples
+    template<unsigned bitCount>
+    using Bits = BitField<details::LeastUnsigned<bitCount>, bitCount>;
+
+    using Flag = BitField<bool, 1>;
+
     static_assert(sizeof(std::chrono::day) == 1);
     using Day = Pod<std::chrono::day, PodTypeId::Day>; // день месяца
 
@@ -121,6 +141,16 @@ namespace serdes
 	using DateTime = Pod<std::chrono::nanoseconds, PodTypeId::DateTime>;
 	using DateTimeB = Pod<std::chrono::nanoseconds, PodTypeId::DateTimeB>;
 
+	//------------------------------------------------------------------------------
+	// Definitions of serdes for variable-length integers (signed ones are zigzag-encoded)
+	using VarUInt32 = Varint<uint32_t>;
+	using VarUInt64 = Varint<uint64_t>;
+	using VarInt32 = Varint<int32_t>;
+	using VarInt64 = Varint<int64_t>;
+
+	using VarUInt = VarUInt64;
+	using VarInt = VarInt64;
+
 	//------------------------------------------------------------------------------
 	// Definitions of serdes for string types
 	using String8 = BaseString<UInt8, Char8>;
@@ -156,6 +186,39 @@ namespace serdes
 	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
 	using List = Sequence<UInt32, TElementSerdes, std::list<ValueT<TElementSerdes>, TAllocator>>;
 
+	// Streaming serdes for ranges of unknown size (including input ranges),
+	// deserialized into std::vector
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using StreamVector = Stream<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>>;
+
+	// Sequence divided into chunks of known byte length, which can be deserialized in parallel
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using ChunkedVector = Chunked<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>>;
+
+	// Sequences of integers or timestamps stored as the first element and the differences
+	// between consecutive elements (DeltaVector) or between consecutive differences (DeltaOfDelta)
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using DeltaVector = Delta<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>, 1>;
+
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using DeltaOfDelta = Delta<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>, 2>;
+
+	// Slowly changing floating-point series compressed with XOR against the previous element (Gorilla)
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using XorFloatVector = XorFloat<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>>;
+
+	// Low-cardinality sequences stored as a dictionary of distinct values and element codes
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using DictVector = Dict<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>>;
+
+	// Integer sequences stored in blocks as differences from the block minimum packed to the minimal bit width
+	template<CSerdes TElementSerdes, typename TAllocator = std::allocator<ValueT<TElementSerdes>>>
+	using PackedIntVector = Packed<UInt32, TElementSerdes, std::vector<ValueT<TElementSerdes>, TAllocator>>;
+
+	// Flags packed 8 per byte
+	template<typename TAllocator = std::allocator<bool>>
+	using BitVector = BitRange<UInt32, std::vector<bool, TAllocator>>;
+
 	//------------------------------------------------------------------------------
 	// Definitions of serdes for standard associative containers
 	template<CSerdes TKeySerdes,
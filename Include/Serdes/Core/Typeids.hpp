@@ -30,6 +30,20 @@ namespace serdes
         Tuple,
         Variant,
         Const,
+        Stream,
+        Chunked,
+        Varint,
+        Delta,
+        XorFloat,
+        Shuffled,
+        Compressed,
+        Dict,
+        Rle,
+        BitRange,
+        BitArray,
+        Packed,
+        BitField,
+        Decimal,
     };
 
     /// Enumeration of value types for POD serdes
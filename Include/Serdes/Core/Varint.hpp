@@ -0,0 +1,171 @@
+#ifndef SERDES_CORE_VARINT_HPP
+#define SERDES_CORE_VARINT_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for variable-length integers
+
+    @details
+        Integers are serialized in the LEB128 format: 7 bits per byte, least
+        significant group first, the high bit of a byte is set when more bytes
+        follow. Signed integers are zigzag-encoded first (0, -1, 1, -2, ... are
+        mapped to 0, 1, 2, 3, ...), so that values of small magnitude occupy
+        few bytes regardless of the sign.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <concepts>
+#include <type_traits>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Maps a signed integer to an unsigned one: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ...
+        [[nodiscard]] constexpr
+        uint64_t ZigZagEncode(int64_t value) noexcept
+        {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        [[nodiscard]] constexpr
+        int64_t ZigZagDecode(uint64_t value) noexcept
+        {
+            return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+        }
+
+        /// Number of bytes of an unsigned LEB128 value
+        [[nodiscard]] constexpr
+        uint32_t VarintSize(uint64_t value) noexcept
+        {
+            uint32_t size = 1;
+            for(; value >= 0x80; value >>= 7)
+                size++;
+            return size;
+        }
+
+        template<COutputIterator TOutputIterator>
+        constexpr
+        TOutputIterator SerializeVarint(TOutputIterator bufpos, uint64_t value)
+        {
+            using IteratorValueType = typename std::iterator_traits<TOutputIterator>::value_type;
+            using TBuffer = std::conditional_t<std::is_same_v<IteratorValueType, void>, uint8_t, IteratorValueType>;
+
+            for(; value >= 0x80; value >>= 7)
+                *bufpos++ = static_cast<TBuffer>(static_cast<uint8_t>(value) | 0x80);
+            *bufpos++ = static_cast<TBuffer>(value);
+            return bufpos;
+        }
+
+        /// @note Bits beyond 64 in malformed data are discarded
+        template<CInputIterator TInputIterator>
+        constexpr
+        TInputIterator DeserializeVarint(TInputIterator bufpos, uint64_t &value)
+        {
+            value = 0;
+            for(unsigned shift = 0;; shift += 7)
+            {
+                const auto byte = static_cast<uint8_t>(*bufpos++);
+                if(shift < 64)
+                    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if(!(byte & 0x80))
+                    return bufpos;
+            }
+        }
+
+        template<CInputIterator TInputIterator>
+        constexpr
+        TInputIterator SkipVarint(TInputIterator bufpos)
+        {
+            while(static_cast<uint8_t>(*bufpos++) & 0x80)
+                ;
+            return bufpos;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Serdes template for variable-length integers
+    /// @tparam TValueType Integer type; signed types are zigzag-encoded
+    template<std::integral TValueType>
+    requires (!std::same_as<TValueType, bool>)
+    struct Varint
+    {
+        using ValueType = TValueType;
+
+        /// Values are zigzag-encoded before serialization
+        static constexpr bool zigzag = std::is_signed_v<ValueType>;
+
+        static constexpr std::array<uint64_t, 1> layoutParameters{zigzag};
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Varint; }
+
+        static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof() { return (sizeof(ValueType) * 8 + 6) / 7; }
+
+        template<CExplicitlyConvertible<ValueType> TValue>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TValue &value) { return details::VarintSize(Encode(static_cast<ValueType>(value))); }
+
+        template<COutputIterator TOutputIterator, CExplicitlyConvertible<ValueType> TValue>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TValue &value)
+        {
+            return details::SerializeVarint(bufpos, Encode(static_cast<ValueType>(value)));
+        }
+
+        template<CInputIterator TInputIterator, CExplicitlyConvertible<ValueType> TValue>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TValue &value)
+        {
+            uint64_t encoded = 0;
+            bufpos = details::DeserializeVarint(bufpos, encoded);
+
+            if constexpr (zigzag)
+                value = static_cast<TValue>(static_cast<ValueType>(details::ZigZagDecode(encoded)));
+            else
+                value = static_cast<TValue>(static_cast<ValueType>(encoded));
+
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos) { return details::SkipVarint(bufpos); }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            cursor.Finish();
+            cursor.Varints(1);
+            return true;
+        }
+
+    private:
+        [[nodiscard]] static constexpr
+        uint64_t Encode(ValueType value) noexcept
+        {
+            if constexpr (zigzag)
+                return details::ZigZagEncode(value);
+            else
+                return value;
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
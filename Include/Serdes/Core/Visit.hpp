@@ -0,0 +1,126 @@
+#ifndef SERDES_CORE_VISIT_HPP
+#define SERDES_CORE_VISIT_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Element-by-element deserialization of ranges
+
+    @details
+        Instead of building a container, the functions in this file deserialize
+        the elements of a serialized range (Sequence, Assoc, String, Stream) one at
+        a time into a single reused element and pass each element to a callback or
+        to an output iterator. Memory usage does not depend on the number of
+        elements, and processing can be stopped early.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Serdes whose elements can be visited
+        template<typename TSerdes>
+        concept CVisitableSerdes = requires
+        {
+            typename TSerdes::SizeSerdes;
+            typename TSerdes::ElementSerdes;
+        } && (TSerdes::GetTypeId() == TypeId::Range || TSerdes::GetTypeId() == TypeId::Stream);
+
+        /// Deserializes elements one by one while the handler returns true;
+        /// the remaining elements are skipped
+        template<CSerdes TSerdes, CInputIterator TInputIterator, typename THandler>
+        constexpr
+        TInputIterator VisitElements(TInputIterator bufpos, THandler &&handler)
+        {
+            using SizeSerdes = typename TSerdes::SizeSerdes;
+            using ElementSerdes = typename TSerdes::ElementSerdes;
+
+            // Element buffer reused between calls
+            ValueT<ElementSerdes> element{};
+            bool proceed = true;
+
+            while(true)
+            {
+                ValueT<SizeSerdes> count{0};
+                bufpos = SizeSerdes::DeserializeFrom(bufpos, count);
+
+                for(uint32_t i = 0; i < count; i++)
+                    if(proceed)
+                    {
+                        bufpos = ElementSerdes::DeserializeFrom(bufpos, element);
+                        proceed = handler(element);
+                    }
+                    else
+                        bufpos = Skip<ElementSerdes>(bufpos);
+
+                // A Range has a single size field; a Stream ends with a zero-size chunk
+                if(TSerdes::GetTypeId() == TypeId::Range || count == 0)
+                    return bufpos;
+            }
+        }
+    }
+
+    /// Calls a function for each element of a serialized range
+    /// @tparam TSerdes Range serdes (Sequence, Assoc, String) or Stream serdes
+    /// @param bufpos Iterator pointing to the serialized range
+    /// @param callback Callable entity taking a reference to the element. The element object
+    /// is reused for the next element, so it may be moved from but must not be referenced later.
+    /// If the callback returns bool, false stops the deserialization of elements.
+    /// @return Iterator pointing to the buffer position immediately after the range
+    /// (the remaining elements are skipped if deserialization was stopped)
+    template<CSerdes TSerdes, CInputIterator TInputIterator, typename TCallback>
+    requires details::CVisitableSerdes<TSerdes>
+             && std::invocable<TCallback &, ValueT<typename TSerdes::ElementSerdes> &>
+    constexpr
+    TInputIterator ForEachElement(TInputIterator bufpos, TCallback &&callback)
+    {
+        return details::VisitElements<TSerdes>(bufpos, [&callback](auto &element)
+        {
+            if constexpr (std::is_void_v<std::invoke_result_t<TCallback &, decltype(element)>>)
+            {
+                callback(element);
+                return true;
+            }
+            else
+                return static_cast<bool>(callback(element));
+        });
+    }
+
+    /// Deserializes the elements of a serialized range into an output iterator
+    /// @tparam TSerdes Range serdes (Sequence, Assoc, String) or Stream serdes
+    /// @param bufpos Iterator pointing to the serialized range
+    /// @param output Iterator to which the elements are moved
+    /// @return Buffer position after the range and the output iterator past the last element written
+    template<CSerdes TSerdes, CInputIterator TInputIterator, typename TOutputIterator>
+    requires details::CVisitableSerdes<TSerdes>
+             && std::output_iterator<TOutputIterator, ValueT<typename TSerdes::ElementSerdes> &&>
+    constexpr
+    std::ranges::in_out_result<TInputIterator, TOutputIterator>
+    DeserializeElements(TInputIterator bufpos, TOutputIterator output)
+    {
+        bufpos = details::VisitElements<TSerdes>(bufpos, [&output](auto &element)
+        {
+            *output++ = std::move(element);
+            return true;
+        });
+        return {std::move(bufpos), std::move(output)};
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
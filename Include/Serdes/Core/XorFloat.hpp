@@ -0,0 +1,364 @@
+#ifndef SERDES_CORE_XORFLOAT_HPP
+#define SERDES_CORE_XORFLOAT_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Serdes template for floating-point sequences with XOR compression
+
+    @details
+        The Gorilla algorithm (T. Pelkonen et al., "Gorilla: A Fast, Scalable,
+        In-Memory Time Series Database", 2015). Consecutive values of a slowly
+        changing series (prices, quantities) share the sign, the exponent and
+        the high bits of the mantissa, so the XOR of the bit representations of
+        neighbouring values has many leading and usually trailing zero bits.
+        Only the bits between them are stored:
+
+            '0'                       - the value equals the previous one
+            '10' + bits               - the nonzero bits lie within the window
+                                        (leading/trailing zero counts) of the
+                                        previous XOR; the window is reused
+            '11' + leading + length-1 + bits
+                                      - a new window: the number of leading zeros
+                                        (5 bits, at most 31), the number of
+                                        meaningful bits minus one (5 bits for
+                                        float, 6 bits for double), and the bits
+
+        Serialized data format:
+
+            [n][first element][bit fields of the elements 2..n, padded to a byte]
+
+        The first element is serialized with the element serdes. The bit
+        fields are packed as described in BitStream.hpp. Values are
+        restored bit-exactly, including NaN payloads and signed zeros.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <bit>
+#include <ranges>
+#include <limits>
+#include <concepts>
+#include <stdexcept>
+#include "Math.hpp"
+#include "Typeids.hpp"
+#include "Concepts.hpp"
+#include "Helpers.hpp"
+#include "Exception.hpp"
+#include "BitStream.hpp"
+#include "Skip.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// @tparam TSizeSerdes Serdes used to serialize/deserialize the number of elements
+    /// @tparam TElementSerdes POD serdes for float or double, used to serialize the first element
+    /// @tparam TValueType Sequential container type
+    template<
+        CSerdes TSizeSerdes,
+        CSerdes TElementSerdes,
+        std::ranges::range TValueType>
+    requires (TSizeSerdes::Sizeof() == 1 || TSizeSerdes::Sizeof() == 2 || TSizeSerdes::Sizeof() == 4)
+             && (TElementSerdes::GetTypeId() == TypeId::Pod)
+             && std::floating_point<ValueT<TElementSerdes>>
+             && (sizeof(ValueT<TElementSerdes>) == 4 || sizeof(ValueT<TElementSerdes>) == 8)
+    struct XorFloat
+    {
+        /// Serdes for serializing/deserializing the number of elements
+        using SizeSerdes = TSizeSerdes;
+
+        /// Serdes for serializing/deserializing the first element
+        using ElementSerdes = TElementSerdes;
+
+        using ElementType = ValueT<ElementSerdes>;
+
+        using ValueType = TValueType;
+
+        /// Unsigned integer with the bit representation of an element
+        using Bits = std::conditional_t<sizeof(ElementType) == 8, uint64_t, uint32_t>;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::XorFloat; }
+
+        [[nodiscard]] static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static consteval
+        uint32_t Sizeof()
+        {
+            constexpr uint64_t maxSize = std::numeric_limits<ValueT<SizeSerdes>>::max();
+            const uint64_t size = SizeSerdes::Sizeof() + ElementSerdes::Sizeof()
+                                + ((maxSize - 1) * maxFieldBits + 7) / 8;
+            return size < WRONG_SIZE ? static_cast<uint32_t>(size) : WRONG_SIZE;
+        }
+
+        /// Exact size of the serialized range
+        /// @note This function may return WRONG_SIZE if the size or the range size exceeds the allowed limit
+        template<std::ranges::forward_range TRange>
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                return WRONG_SIZE;
+            if(size == 0)
+                return SizeSerdes::Sizeof();
+
+            details::BitCounter counter;
+            Encode(range, counter);
+
+            const uint64_t bufSize = SizeSerdes::Sizeof() + ElementSerdes::Sizeof() + counter.Bytes();
+            return bufSize < WRONG_SIZE ? static_cast<uint32_t>(bufSize) : WRONG_SIZE;
+        }
+
+        /// @throw std::length_error if the size of the range exceeds the limit of the size field
+        template<COutputIterator TOutputIterator, std::ranges::forward_range TRange>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const TRange &range)
+        {
+            const size_t size = std::ranges::size(range);
+            if(size > std::numeric_limits<ValueT<SizeSerdes>>::max())
+                utils::Throw<std::length_error>("range size exceeds the limit of the size field");
+
+            bufpos = SizeSerdes::SerializeTo(bufpos, size);
+            if(size == 0)
+                return bufpos;
+
+            bufpos = ElementSerdes::SerializeTo(bufpos, *std::ranges::begin(range));
+
+            details::BitWriter writer(bufpos);
+            Encode(range, writer);
+            return writer.Finish();
+        }
+
+        template<CInputIterator TInputIterator, std::ranges::forward_range TSequence>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, TSequence &sequence)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+
+            sequence.resize(size);
+            if(size == 0)
+                return bufpos;
+
+            ElementType first{};
+            bufpos = ElementSerdes::DeserializeFrom(bufpos, first);
+
+            auto element = std::ranges::begin(sequence);
+            *element++ = first;
+
+            details::BitReader reader(bufpos);
+            Decoder decoder{std::bit_cast<Bits>(first)};
+            for(size_t i = 1; i < size; i++)
+                *element++ = std::bit_cast<ElementType>(decoder.Next(reader));
+
+            return reader.Finish();
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            ValueT<SizeSerdes> size{0};
+            bufpos = SizeSerdes::DeserializeFrom(bufpos, size);
+            if(size == 0)
+                return bufpos;
+
+            bufpos = details::Advance(bufpos, ElementSerdes::Sizeof());
+
+            details::BitReader reader(bufpos);
+            Decoder decoder{};
+            for(size_t i = 1; i < size; i++)
+                (void)decoder.Next(reader);
+
+            return reader.Finish();
+        }
+
+        /// Scans a serialized value received in fragments (see IncrementalDecoder)
+        // Stage 1: the first element is next; stage 2: Count is the number of unscanned bit fields,
+        // Param is the bit offset in the first unscanned byte and the window length (shifted by 3).
+        // A bit field is scanned only when all of its bytes are available.
+        template<typename TCursor>
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            if(cursor.Stage() == 0)
+            {
+                ValueT<SizeSerdes> size{0};
+                if(!cursor.template Read<SizeSerdes>(size))
+                    return false;
+                if(size == 0)
+                {
+                    cursor.Finish();
+                    return true;
+                }
+                cursor.Count() = size - 1;
+                cursor.Stage() = 1;
+            }
+
+            if(cursor.Stage() == 1)
+            {
+                if(!cursor.Need(ElementSerdes::Sizeof()))
+                    return false;
+                cursor.Consume(ElementSerdes::Sizeof());
+                cursor.Stage() = 2;
+            }
+
+            uint64_t pos = cursor.Param() & 7;
+            unsigned length = static_cast<unsigned>(cursor.Param() >> 3);
+            for(; cursor.Count(); cursor.Count()--)
+            {
+                if(!ScanField(cursor, pos, length))
+                {
+                    cursor.Param() = pos | length << 3;
+                    return false;
+                }
+
+                // Whole bytes of the scanned bit fields are consumed
+                cursor.Consume(pos / 8);
+                pos %= 8;
+            }
+
+            // Padding of the last byte
+            cursor.Consume(pos != 0);
+            cursor.Finish();
+            return true;
+        }
+
+    private:
+        static constexpr unsigned bitWidth = sizeof(Bits) * 8;
+
+        /// Width of the field with the number of leading zeros
+        static constexpr unsigned leadingBits = 5;
+
+        /// Width of the field with the number of meaningful bits minus one
+        static constexpr unsigned lengthBits = std::bit_width(bitWidth - 1);
+
+        /// Maximum number of bits per element
+        static constexpr unsigned maxFieldBits = 2 + leadingBits + lengthBits + bitWidth;
+
+        /// Writes the bit fields of the elements following the first one to a BitWriter or a BitCounter
+        template<std::ranges::forward_range TRange, typename TBitWriter>
+        static constexpr
+        void Encode(const TRange &range, TBitWriter &writer)
+        {
+            auto it = std::ranges::begin(range);
+            Bits previous = std::bit_cast<Bits>(static_cast<ElementType>(*it));
+
+            // The window of the previous XOR; initially there is none
+            unsigned windowLeading = bitWidth;
+            unsigned windowTrailing = 0;
+
+            for(++it; it != std::ranges::end(range); ++it)
+            {
+                const Bits current = std::bit_cast<Bits>(static_cast<ElementType>(*it));
+                const Bits diff = current ^ previous;
+                previous = current;
+
+                if(diff == 0)
+                {
+                    writer.Write(0b0, 1);
+                    continue;
+                }
+
+                const unsigned leading = std::min<unsigned>(std::countl_zero(diff), (1u << leadingBits) - 1);
+                const unsigned trailing = std::countr_zero(diff);
+
+                if(leading >= windowLeading && trailing >= windowTrailing)
+                {
+                    writer.Write(0b01, 2);
+                    writer.Write(diff >> windowTrailing, bitWidth - windowLeading - windowTrailing);
+                }
+                else
+                {
+                    const unsigned length = bitWidth - leading - trailing;
+                    writer.Write(0b11 | leading << 2 | (length - 1) << (2 + leadingBits), 2 + leadingBits + lengthBits);
+                    writer.Write(diff >> trailing, length);
+
+                    windowLeading = leading;
+                    windowTrailing = trailing;
+                }
+            }
+        }
+
+        /// Reads count bits of the input starting at a bit position (in the order of BitReader)
+        [[nodiscard]] static constexpr
+        uint64_t PeekBits(const uint8_t *data, uint64_t pos, unsigned count) noexcept
+        {
+            uint64_t value = 0;
+            for(unsigned i = 0; i < count; i++, pos++)
+                value |= static_cast<uint64_t>(data[pos / 8] >> pos % 8 & 1) << i;
+            return value;
+        }
+
+        /// Moves a bit position past the bit field of an element, updating the window length
+        /// @return false if the bit field is not available (the missing bytes are reported)
+        template<typename TCursor>
+        static constexpr
+        bool ScanField(TCursor &cursor, uint64_t &pos, unsigned &length)
+        {
+            const auto has = [&cursor, pos](uint64_t bits) { return cursor.Need((pos + bits + 7) / 8); };
+
+            if(!has(1))
+                return false;
+            if(!PeekBits(cursor.Data(), pos, 1))
+            {
+                pos++;
+                return true;
+            }
+
+            if(!has(2))
+                return false;
+
+            uint64_t header = 2;
+            unsigned fieldLength = length;
+            if(PeekBits(cursor.Data(), pos + 1, 1))
+            {
+                header += leadingBits + lengthBits;
+                if(!has(header))
+                    return false;
+                fieldLength = static_cast<unsigned>(PeekBits(cursor.Data(), pos + 2 + leadingBits, lengthBits)) + 1;
+            }
+
+            if(!has(header + fieldLength))
+                return false;
+
+            pos += header + fieldLength;
+            length = fieldLength;
+            return true;
+        }
+
+        /// Restores the elements following the first one
+        struct Decoder
+        {
+            Bits previous = 0;
+            unsigned windowLength = 0;
+            unsigned windowTrailing = 0;
+
+            template<typename TBitReader>
+            constexpr
+            Bits Next(TBitReader &reader)
+            {
+                if(!reader.ReadBit())
+                    return previous;
+
+                if(reader.ReadBit())
+                {
+                    const auto header = static_cast<unsigned>(reader.Read(leadingBits + lengthBits));
+                    const unsigned leading = header & ((1u << leadingBits) - 1);
+                    windowLength = (header >> leadingBits) + 1;
+                    windowTrailing = bitWidth - leading - windowLength;
+                }
+
+                previous ^= static_cast<Bits>(reader.Read(windowLength) << windowTrailing);
+                return previous;
+            }
+        };
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
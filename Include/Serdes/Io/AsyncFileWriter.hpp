@@ -0,0 +1,758 @@
+#ifndef SERDES_IO_ASYNCFILEWRITER_HPP
+#define SERDES_IO_ASYNCFILEWRITER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Asynchronous double-buffered writer to a file
+
+    @details
+        AsyncFileWriter serializes into one of two buffers while the other one is
+        being written to the file in the background. Writes are submitted through
+        io_uring; if io_uring is unavailable (old kernel, seccomp restrictions),
+        a background thread performing pwrite() is used instead.
+
+        io_uring is used only if the kernel supports IORING_OP_WRITE (Linux 5.6+),
+        which is checked with IORING_REGISTER_PROBE.
+
+        Each submission (Flush, Sync) returns a ticket. Completion of a ticket is
+        observable without blocking (Completed) or can be awaited (Wait), so the
+        caller can wait for durability without stalling the encoder:
+
+            AsyncFileWriter writer("journal.bin");
+            SerializeTo<Entry>(writer.begin(), entry);
+            auto ticket = writer.Sync();  // returns immediately
+            ...
+            writer.Wait(ticket);          // the entry has reached the storage device
+
+        The encoder blocks only when it fills a buffer while the previous write
+        from the other buffer is still in progress.
+
+        fdatasync is started only after all preceding writes, including the
+        remainders of short writes, have completed. A failed write or fdatasync
+        makes the writer fail: every following Completed(), Wait() and Flush()
+        throws the first error, with either backend.
+
+        The implementation uses Linux system calls (io_uring, pwrite, fdatasync).
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <string>
+#include <vector>
+#include <format>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "../Core/Exception.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// AsyncFileWriter options
+    struct AsyncWriterOptions
+    {
+        /// Size of each of the two buffers
+        size_t bufferSize = size_t(4) << 20;
+
+        /// File offset at which writing starts
+        uint64_t offset = 0;
+
+        /// Try io_uring before falling back to the pwrite thread
+        bool useIoUring = true;
+    };
+
+    namespace details
+    {
+        /// Request to the background writer: a block to write or, if data == nullptr, fdatasync
+        struct AsyncRequest
+        {
+            uint64_t ticket;
+            const uint8_t *data;
+            size_t size;
+            uint64_t offset;
+        };
+
+        //----------------------------------------------------------------------
+        /// Background thread performing requests in submission order
+        class PwriteThread
+        {
+        public:
+            explicit
+            PwriteThread(int fd) : _fd(fd), _thread([this] { Run(); }) {}
+
+            ~PwriteThread()
+            {
+                {
+                    std::lock_guard lock(_mutex);
+                    _stop = true;
+                }
+                _cv.notify_all();
+                _thread.join();
+            }
+
+            void Submit(const AsyncRequest &request)
+            {
+                {
+                    std::lock_guard lock(_mutex);
+                    _queue.push_back(request);
+                }
+                _cv.notify_all();
+            }
+
+            [[nodiscard]]
+            uint64_t Completed()
+            {
+                std::lock_guard lock(_mutex);
+                ThrowIfFailed();
+                return _completed;
+            }
+
+            void Wait(uint64_t ticket)
+            {
+                std::unique_lock lock(_mutex);
+                _cv.wait(lock, [&] { return _completed >= ticket || !_error.empty(); });
+                ThrowIfFailed();
+            }
+
+        private:
+            void Run()
+            {
+                std::unique_lock lock(_mutex);
+                while(true)
+                {
+                    _cv.wait(lock, [&] { return _stop || !_queue.empty(); });
+                    if(_queue.empty())
+                        return;
+
+                    const AsyncRequest request = _queue.front();
+                    _queue.pop_front();
+
+                    lock.unlock();
+                    const std::string error = Perform(request);
+                    lock.lock();
+
+                    if(!error.empty() && _error.empty())
+                        _error = error;
+                    _completed = request.ticket;
+                    _cv.notify_all();
+                }
+            }
+
+            std::string Perform(AsyncRequest request) const
+            {
+                if(!request.data)
+                    return ::fdatasync(_fd) == 0 ? std::string() : std::format("fdatasync failed: {}", std::strerror(errno));
+
+                while(request.size)
+                {
+                    const ssize_t n = ::pwrite(_fd, request.data, request.size, static_cast<off_t>(request.offset));
+                    if(n < 0)
+                    {
+                        if(errno == EINTR)
+                            continue;
+                        return std::format("pwrite failed: {}", std::strerror(errno));
+                    }
+                    request.data += n;
+                    request.size -= static_cast<size_t>(n);
+                    request.offset += static_cast<uint64_t>(n);
+                }
+                return {};
+            }
+
+            void ThrowIfFailed() const
+            {
+                if(!_error.empty())
+                    utils::Throw<std::runtime_error>(_error);
+            }
+
+            int _fd;
+            std::mutex _mutex;
+            std::condition_variable _cv;
+            std::deque<AsyncRequest> _queue;
+            uint64_t _completed = 0;
+            std::string _error;
+            bool _stop = false;
+            std::thread _thread;
+        };
+
+        //----------------------------------------------------------------------
+        /// Minimal io_uring submission/completion queue pair (without liburing)
+        class IoUring
+        {
+        public:
+            /// Creates the ring
+            /// @return nullptr if io_uring is not available
+            static std::unique_ptr<IoUring> Create(int fd)
+            {
+                auto ring = std::unique_ptr<IoUring>(new IoUring(fd));
+                return ring->_ringFd >= 0 ? std::move(ring) : nullptr;
+            }
+
+            IoUring(const IoUring &) = delete;
+            IoUring &operator=(const IoUring &) = delete;
+
+            ~IoUring()
+            {
+                if(_sqes)
+                    ::munmap(_sqes, _sqesSize);
+                if(_cq && _cq != _sq)
+                    ::munmap(_cq, _cqSize);
+                if(_sq)
+                    ::munmap(_sq, _sqSize);
+                if(_ringFd >= 0)
+                    ::close(_ringFd);
+            }
+
+            void Submit(const AsyncRequest &request)
+            {
+                // The number of requests in flight is limited by the size of the completion
+                // queue, so completions are not lost if the caller does not reap them
+                while(Reap(), _inFlight >= _cqEntries)
+                    WaitEvent();
+
+                // fdatasync is held until the preceding writes are complete
+                _pending.push_back({request, false, request.data != nullptr});
+                if(request.data)
+                    Push(request);
+                else
+                    SubmitHeld();
+            }
+
+            /// Processes available completions without waiting
+            /// @throw std::runtime_error if a request has failed
+            [[nodiscard]]
+            uint64_t Completed()
+            {
+                Reap();
+                ThrowIfFailed();
+                return _completed;
+            }
+
+            /// @throw std::runtime_error if a request has failed
+            void Wait(uint64_t ticket)
+            {
+                while(Reap(), _error.empty() && _completed < ticket)
+                    WaitEvent();
+                ThrowIfFailed();
+            }
+
+        private:
+            static constexpr unsigned entries = 8;
+
+            /// Maximum length of a single write (sqe.len is 32-bit); longer blocks are
+            /// written in parts like short writes
+            static constexpr size_t maxWriteSize = size_t(1) << 30;
+
+            struct Pending
+            {
+                AsyncRequest request;
+                bool done;
+
+                /// The request has been placed into the submission queue
+                bool submitted;
+            };
+
+            explicit
+            IoUring(int fd) : _fd(fd)
+            {
+                io_uring_params params{};
+                _ringFd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+                if(_ringFd < 0)
+                    return;
+
+                if(!IsWriteSupported())
+                {
+                    ::close(_ringFd);
+                    _ringFd = -1;
+                    return;
+                }
+
+                _cqEntries = params.cq_entries;
+
+                _sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                _cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+                const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+                if(singleMap)
+                    _sqSize = _cqSize = std::max(_sqSize, _cqSize);
+
+                _sq = Map(_sqSize, IORING_OFF_SQ_RING);
+                _cq = singleMap ? _sq : Map(_cqSize, IORING_OFF_CQ_RING);
+                _sqes = static_cast<io_uring_sqe *>(Map(_sqesSize, IORING_OFF_SQES));
+
+                if(!_sq || !_cq || !_sqes)
+                {
+                    ::close(_ringFd);
+                    _ringFd = -1;
+                    return;
+                }
+
+                auto *sq = static_cast<uint8_t *>(_sq);
+                _sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+                _sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+                _sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+                auto *cq = static_cast<uint8_t *>(_cq);
+                _cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+                _cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+                _cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+                _cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+            }
+
+            /// Checks whether the kernel supports IORING_OP_WRITE (IORING_REGISTER_PROBE is
+            /// available since Linux 5.6, as is IORING_OP_WRITE)
+            bool IsWriteSupported() const noexcept
+            {
+                constexpr unsigned opCount = IORING_OP_WRITE + 1;
+                alignas(io_uring_probe) uint8_t storage[sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op)]{};
+                auto *probe = reinterpret_cast<io_uring_probe *>(storage);
+
+                if(::syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_PROBE, probe, opCount) < 0)
+                    return false;
+
+                return probe->last_op >= IORING_OP_WRITE && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+            }
+
+            void *Map(size_t size, off_t offset) const noexcept
+            {
+                void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, offset);
+                return addr == MAP_FAILED ? nullptr : addr;
+            }
+
+            int Enter(unsigned toSubmit, unsigned minComplete, unsigned flags) const noexcept
+            {
+                return static_cast<int>(::syscall(__NR_io_uring_enter, _ringFd, toSubmit, minComplete, flags, nullptr, 0));
+            }
+
+            /// Waits for at least one completion
+            void WaitEvent() const
+            {
+                if(Enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                    utils::Throw<std::runtime_error>(std::format("io_uring_enter failed: {}", std::strerror(errno)));
+            }
+
+            /// Places the request into the submission queue and submits it
+            void Push(const AsyncRequest &request)
+            {
+                const unsigned tail = *_sqTail; // the writer is the only producer
+                const unsigned index = tail & _sqMask;
+
+                io_uring_sqe &sqe = _sqes[index];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.fd = _fd;
+                sqe.user_data = request.ticket;
+
+                if(request.data)
+                {
+                    sqe.opcode = IORING_OP_WRITE;
+                    sqe.addr = reinterpret_cast<uint64_t>(request.data);
+                    sqe.len = static_cast<uint32_t>(std::min(request.size, maxWriteSize));
+                    sqe.off = request.offset;
+                }
+                else
+                {
+                    sqe.opcode = IORING_OP_FSYNC;
+                    sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+                }
+
+                _sqArray[index] = index;
+                std::atomic_ref<unsigned>(*_sqTail).store(tail + 1, std::memory_order_release);
+                _inFlight++;
+
+                while(Enter(1, 0, 0) < 0)
+                    if(errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                        utils::Throw<std::runtime_error>(std::format("io_uring_enter failed: {}", std::strerror(errno)));
+            }
+
+            /// Submits held fdatasync requests not preceded by unfinished writes
+            void SubmitHeld()
+            {
+                for(auto &p: _pending)
+                {
+                    if(p.request.data && !p.done)
+                        return;
+                    if(!p.submitted && _inFlight < _cqEntries)
+                    {
+                        p.submitted = true;
+                        Push(p.request);
+                    }
+                }
+            }
+
+            void ThrowIfFailed() const
+            {
+                if(!_error.empty())
+                    utils::Throw<std::runtime_error>(_error);
+            }
+
+            /// Processes the completion queue; the first error is kept
+            void Reap()
+            {
+                unsigned head = std::atomic_ref<unsigned>(*_cqHead).load(std::memory_order_relaxed);
+                const unsigned first = head;
+                const unsigned tail = std::atomic_ref<unsigned>(*_cqTail).load(std::memory_order_acquire);
+
+                for(; head != tail; head++)
+                {
+                    const io_uring_cqe &cqe = _cqes[head & _cqMask];
+                    auto it = std::ranges::find(_pending, cqe.user_data, [](const Pending &p) { return p.request.ticket; });
+                    if(it == _pending.end())
+                        continue;
+
+                    if(cqe.res < 0)
+                    {
+                        if(_error.empty())
+                            _error = std::format("asynchronous {} failed: {}", it->request.data ? "write" : "fdatasync",
+                                                 std::strerror(-cqe.res));
+                        it->done = true;
+                    }
+                    else if(it->request.data && static_cast<size_t>(cqe.res) < it->request.size)
+                    {
+                        // Short write: the rest of the block is resubmitted
+                        it->request.data += cqe.res;
+                        it->request.size -= static_cast<size_t>(cqe.res);
+                        it->request.offset += static_cast<uint64_t>(cqe.res);
+                        _resubmit.push_back(it->request);
+                    }
+                    else
+                        it->done = true;
+                }
+                std::atomic_ref<unsigned>(*_cqHead).store(head, std::memory_order_release);
+                _inFlight -= tail - first;
+
+                // Each resubmitted request replaces a reaped completion
+                for(const auto &request: _resubmit)
+                    Push(request);
+                _resubmit.clear();
+
+                // All requests up to the first unfinished one are complete
+                std::erase_if(_pending, [&](const Pending &p)
+                {
+                    if(!p.done)
+                        return false;
+                    _last = std::max(_last, p.request.ticket);
+                    return true;
+                });
+
+                _completed = _last;
+                for(const auto &p: _pending)
+                    _completed = std::min(_completed, p.request.ticket - 1);
+
+                SubmitHeld();
+            }
+
+            int _fd;
+            int _ringFd = -1;
+
+            void *_sq = nullptr;
+            void *_cq = nullptr;
+            io_uring_sqe *_sqes = nullptr;
+            size_t _sqSize = 0;
+            size_t _cqSize = 0;
+            size_t _sqesSize = 0;
+
+            unsigned *_sqTail = nullptr;
+            unsigned *_sqArray = nullptr;
+            unsigned _sqMask = 0;
+            unsigned *_cqHead = nullptr;
+            unsigned *_cqTail = nullptr;
+            unsigned _cqMask = 0;
+            io_uring_cqe *_cqes = nullptr;
+            unsigned _cqEntries = 0;
+
+            /// Number of submitted entries whose completions have not been reaped
+            unsigned _inFlight = 0;
+
+            /// Submitted requests that have not been completed
+            std::vector<Pending> _pending;
+            std::vector<AsyncRequest> _resubmit;
+
+            /// Highest finished ticket
+            uint64_t _last = 0;
+
+            /// All tickets up to this one are complete
+            uint64_t _completed = 0;
+
+            /// The first error
+            std::string _error;
+        };
+    }
+
+    //--------------------------------------------------------------------------
+    /// Asynchronous double-buffered writer to a file
+    class AsyncFileWriter
+    {
+    public:
+        /// Alignment of the buffers
+        static constexpr size_t alignment = 4096;
+
+        /// Output iterator writing to the AsyncFileWriter
+        class Iterator
+        {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            Iterator() = default;
+
+            explicit
+            Iterator(AsyncFileWriter *writer) : _writer(writer) {}
+
+            Iterator &operator=(uint8_t byte)
+            {
+                _writer->Put(byte);
+                return *this;
+            }
+
+            Iterator &operator=(std::byte byte) { return *this = static_cast<uint8_t>(byte); }
+
+            Iterator &operator*() { return *this; }
+            Iterator &operator++() { return *this; }
+            Iterator operator++(int) { return *this; }
+
+            /// Writes a block of bytes
+            Iterator WriteBlock(const uint8_t *data, size_t size)
+            {
+                _writer->Write(data, size);
+                return *this;
+            }
+
+        private:
+            AsyncFileWriter *_writer = nullptr;
+        };
+
+        /// Creates (or truncates) and opens the file for writing
+        /// @throw std::runtime_error if the file cannot be opened
+        explicit
+        AsyncFileWriter(const std::string &path, const AsyncWriterOptions &options = {})
+        {
+            _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if(_fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot open '{}': {}", path, std::strerror(errno)));
+            _ownsFd = true;
+            Init(options);
+        }
+
+        /// Writes to an already open file descriptor (the descriptor is not closed by the writer)
+        explicit
+        AsyncFileWriter(int fd, const AsyncWriterOptions &options = {}) : _fd(fd)
+        {
+            Init(options);
+        }
+
+        AsyncFileWriter(const AsyncFileWriter &) = delete;
+        AsyncFileWriter &operator=(const AsyncFileWriter &) = delete;
+
+        /// Writes the buffered data, waits for completion and closes the file
+        /// @note Errors are ignored; call Close() explicitly to handle them.
+        ~AsyncFileWriter()
+        {
+            try { Close(); } catch(...) {}
+            _uring.reset();
+            _thread.reset();
+            std::free(_buffers[0]);
+            std::free(_buffers[1]);
+        }
+
+        /// Returns an output iterator for serialization
+        [[nodiscard]]
+        Iterator begin() noexcept { return Iterator(this); }
+
+        /// Writes a byte
+        void Put(uint8_t byte)
+        {
+            if(_pos == _capacity)
+                Flush();
+            _buffers[_active][_pos++] = byte;
+        }
+
+        /// Writes a block of bytes
+        void Write(const uint8_t *data, size_t size)
+        {
+            while(size)
+            {
+                if(_pos == _capacity)
+                    Flush();
+
+                const size_t n = std::min(size, _capacity - _pos);
+                std::memcpy(_buffers[_active] + _pos, data, n);
+                _pos += n;
+                data += n;
+                size -= n;
+            }
+        }
+
+        /// Submits the active buffer for writing and switches to the other buffer
+        /// @return Ticket completed when the data submitted so far has been written
+        /// @note Blocks only while the other buffer is still being written.
+        /// @throw std::runtime_error if a write or fdatasync has failed
+        uint64_t Flush()
+        {
+            if(_pos == 0)
+                return _lastTicket;
+
+            const uint64_t ticket = Submit({0, _buffers[_active], _pos, _offset});
+            _bufferTicket[_active] = ticket;
+            _offset += _pos;
+            _pos = 0;
+
+            // The next buffer can be reused once its previous write is complete
+            _active ^= 1;
+            Wait(_bufferTicket[_active]);
+
+            return ticket;
+        }
+
+        /// Submits the buffered data followed by fdatasync
+        /// @return Ticket completed when the data written so far has reached the storage device
+        /// @throw std::runtime_error if a write or fdatasync has failed
+        uint64_t Sync()
+        {
+            Flush();
+            return Submit({0, nullptr, 0, 0});
+        }
+
+        /// Returns the highest ticket such that all tickets up to it are complete (does not block)
+        /// @throw std::runtime_error if a write or fdatasync has failed
+        [[nodiscard]]
+        uint64_t Completed() { return _uring ? _uring->Completed() : _thread->Completed(); }
+
+        /// Checks whether the ticket is complete (does not block)
+        [[nodiscard]]
+        bool IsComplete(uint64_t ticket) { return Completed() >= ticket; }
+
+        /// Waits for completion of the ticket
+        /// @throw std::runtime_error if a write or fdatasync has failed (including earlier ones)
+        void Wait(uint64_t ticket)
+        {
+            if(_uring)
+                _uring->Wait(ticket);
+            else
+                _thread->Wait(ticket);
+        }
+
+        /// Writes the buffered data, waits for all writes and closes the file (if it was opened by the writer)
+        /// @note The writer is closed even if an exception is thrown.
+        void Close()
+        {
+            if(_fd < 0)
+                return;
+
+            try
+            {
+                Wait(Flush());
+            }
+            catch(...)
+            {
+                _pos = 0;
+                ReleaseFd();
+                throw;
+            }
+
+            if(!ReleaseFd())
+                utils::Throw<std::runtime_error>(std::format("close failed: {}", std::strerror(errno)));
+        }
+
+        /// Checks whether writes are performed through io_uring
+        [[nodiscard]]
+        bool UsesIoUring() const noexcept { return _uring != nullptr; }
+
+        /// Number of bytes passed to the writer
+        [[nodiscard]]
+        uint64_t Position() const noexcept { return _offset - _startOffset + _pos; }
+
+    private:
+        void Init(const AsyncWriterOptions &options)
+        {
+            _startOffset = _offset = options.offset;
+            _capacity = (std::max(options.bufferSize, alignment) + alignment - 1) / alignment * alignment;
+
+            _buffers[0] = static_cast<uint8_t *>(std::aligned_alloc(alignment, _capacity));
+            _buffers[1] = static_cast<uint8_t *>(std::aligned_alloc(alignment, _capacity));
+            if(!_buffers[0] || !_buffers[1])
+            {
+                std::free(_buffers[0]);
+                std::free(_buffers[1]);
+                if(_ownsFd)
+                    ::close(_fd);
+                throw std::bad_alloc();
+            }
+
+            if(options.useIoUring)
+                _uring = details::IoUring::Create(_fd);
+            if(!_uring)
+                _thread = std::make_unique<details::PwriteThread>(_fd);
+        }
+
+        /// Closes the descriptor if it is owned by the writer
+        /// @return false if close() failed (errno is set)
+        bool ReleaseFd() noexcept
+        {
+            const int fd = std::exchange(_fd, -1);
+            return !_ownsFd || ::close(fd) == 0;
+        }
+
+        uint64_t Submit(details::AsyncRequest request)
+        {
+            request.ticket = ++_lastTicket;
+            if(_uring)
+                _uring->Submit(request);
+            else
+                _thread->Submit(request);
+            return request.ticket;
+        }
+
+        /// File descriptor
+        int _fd = -1;
+
+        /// The descriptor was opened by the writer and is closed by it
+        bool _ownsFd = false;
+
+        std::unique_ptr<details::IoUring> _uring;
+        std::unique_ptr<details::PwriteThread> _thread;
+
+        /// Double buffer
+        uint8_t *_buffers[2] = {nullptr, nullptr};
+
+        /// Tickets of the last writes from each buffer
+        uint64_t _bufferTicket[2] = {0, 0};
+
+        /// Index of the buffer being filled
+        unsigned _active = 0;
+        size_t _capacity = 0;
+        size_t _pos = 0;
+
+        /// File offset of the next write
+        uint64_t _offset = 0;
+        uint64_t _startOffset = 0;
+
+        uint64_t _lastTicket = 0;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
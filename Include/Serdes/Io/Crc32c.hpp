@@ -0,0 +1,91 @@
+#ifndef SERDES_IO_CRC32C_HPP
+#define SERDES_IO_CRC32C_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief CRC-32C (Castagnoli) checksum
+
+    @details
+        Uses the SSE4.2 crc32 instruction when the code is compiled for it
+        (-msse4.2 or -march with SSE4.2 support), otherwise a table-driven
+        implementation processing 8 bytes per step.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    namespace details
+    {
+        /// Lookup tables for the slicing-by-8 CRC-32C algorithm
+        inline constexpr auto crc32cTables = []
+        {
+            constexpr uint32_t polynomial = 0x82F63B78; // reversed Castagnoli polynomial
+
+            std::array<std::array<uint32_t, 256>, 8> tables{};
+            for(uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t crc = i;
+                for(int bit = 0; bit < 8; bit++)
+                    crc = (crc >> 1) ^ (crc & 1 ? polynomial : 0);
+                tables[0][i] = crc;
+            }
+
+            for(size_t t = 1; t < 8; t++)
+                for(uint32_t i = 0; i < 256; i++)
+                    tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+
+            return tables;
+        }();
+    }
+
+    /// Computes CRC-32C of a block of data
+    /// @param crc Checksum of the preceding data, to compute the checksum incrementally
+    [[nodiscard]] inline
+    uint32_t Crc32c(const uint8_t *data, size_t size, uint32_t crc = 0) noexcept
+    {
+        crc = ~crc;
+
+#if defined(__SSE4_2__)
+        uint64_t crc64 = crc;
+        for(; size >= 8; data += 8, size -= 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data, 8);
+            crc64 = _mm_crc32_u64(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+
+        for(; size; data++, size--)
+            crc = _mm_crc32_u8(crc, *data);
+#else
+        const auto &t = details::crc32cTables;
+        for(; size >= 8; data += 8, size -= 8)
+        {
+            const uint32_t low = crc ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24);
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+                ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        }
+
+        for(; size; data++, size--)
+            crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+#endif
+
+        return ~crc;
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
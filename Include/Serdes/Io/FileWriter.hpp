@@ -0,0 +1,398 @@
+#ifndef SERDES_IO_FILEWRITER_HPP
+#define SERDES_IO_FILEWRITER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Buffered writer to a file descriptor
+
+    @details
+        FileWriter stages output in a large page-aligned buffer and writes it to the
+        file in big write() or pwrite() calls. Its iterator satisfies COutputIterator,
+        so any serdes can serialize directly into a file:
+
+            FileWriter writer("state.bin");
+            SerializeTo<MySerdes>(writer.begin(), value);
+            writer.Close();
+
+        The iterator also accepts whole blocks of bytes (CBlockOutputIterator), which
+        lets contiguous ranges of POD values bypass the byte-by-byte path.
+
+        Optional policies:
+        - O_DIRECT output (the buffer size is rounded up to the direct I/O alignment,
+          the start offset must be aligned; the unaligned tail is written without
+          O_DIRECT when the writer is closed, and O_DIRECT is restored afterwards on
+          descriptors owned by the caller);
+        - periodic fdatasync after a given number of bytes or a given time interval.
+
+        The implementation uses POSIX I/O and is intended for Linux.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <format>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../Core/Exception.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// FileWriter options
+    struct WriterOptions
+    {
+        /// Size of the staging buffer
+        size_t bufferSize = size_t(1) << 20;
+
+        /// Open the file with O_DIRECT (bypassing the page cache)
+        bool direct = false;
+
+        /// Write with pwrite() starting at this offset; -1 - write() at the current file offset
+        int64_t offset = -1;
+
+        /// Call fdatasync after this number of bytes has been written (0 - never)
+        uint64_t syncBytes = 0;
+
+        /// Call fdatasync if this time has passed since the previous synchronization (0 - never)
+        std::chrono::milliseconds syncPeriod{0};
+    };
+
+    //--------------------------------------------------------------------------
+    /// Buffered writer to a file descriptor
+    class FileWriter
+    {
+    public:
+        /// Alignment of the staging buffer and of O_DIRECT writes
+        static constexpr size_t alignment = 4096;
+
+        /// Output iterator writing to the FileWriter
+        class Iterator
+        {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            Iterator() = default;
+
+            explicit
+            Iterator(FileWriter *writer) : _writer(writer) {}
+
+            Iterator &operator=(uint8_t byte)
+            {
+                _writer->Put(byte);
+                return *this;
+            }
+
+            Iterator &operator=(std::byte byte) { return *this = static_cast<uint8_t>(byte); }
+
+            Iterator &operator*() { return *this; }
+            Iterator &operator++() { return *this; }
+            Iterator operator++(int) { return *this; }
+
+            /// Writes a block of bytes
+            Iterator WriteBlock(const uint8_t *data, size_t size)
+            {
+                _writer->Write(data, size);
+                return *this;
+            }
+
+        private:
+            FileWriter *_writer = nullptr;
+        };
+
+        /// Creates (or truncates) and opens the file for writing
+        /// @throw std::runtime_error if the file cannot be opened
+        /// @throw std::invalid_argument if O_DIRECT output starts at an unaligned offset
+        explicit
+        FileWriter(const std::string &path, const WriterOptions &options = {})
+            : _options(options)
+        {
+            const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (options.direct ? O_DIRECT : 0);
+            _fd = ::open(path.c_str(), flags, 0644);
+            if(_fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot open '{}': {}", path, std::strerror(errno)));
+            _ownsFd = true;
+            Init();
+        }
+
+        /// Writes to an already open file descriptor (the descriptor is not closed by the writer)
+        /// @note With options.direct, the descriptor must have been opened with O_DIRECT.
+        /// @throw std::invalid_argument if O_DIRECT output starts at an unaligned offset
+        explicit
+        FileWriter(int fd, const WriterOptions &options = {})
+            : _options(options), _fd(fd)
+        {
+            Init();
+        }
+
+        FileWriter(const FileWriter &) = delete;
+        FileWriter &operator=(const FileWriter &) = delete;
+
+        /// Flushes the buffered data and closes the file
+        /// @note Errors are ignored; call Close() explicitly to handle them.
+        ~FileWriter()
+        {
+            try { Close(); } catch(...) {}
+            std::free(_buffer);
+        }
+
+        /// Returns an output iterator for serialization
+        [[nodiscard]]
+        Iterator begin() noexcept { return Iterator(this); }
+
+        /// Writes a byte
+        void Put(uint8_t byte)
+        {
+            if(_pos == _capacity)
+                FlushBuffer();
+            _buffer[_pos++] = byte;
+        }
+
+        /// Writes a block of bytes
+        void Write(const uint8_t *data, size_t size)
+        {
+            // Large blocks are written directly when nothing is buffered
+            if(!_options.direct && _pos == 0 && size >= _capacity)
+            {
+                WriteOut(data, size);
+                return;
+            }
+
+            while(size)
+            {
+                if(_pos == _capacity)
+                    FlushBuffer();
+
+                const size_t n = std::min(size, _capacity - _pos);
+                std::memcpy(_buffer + _pos, data, n);
+                _pos += n;
+                data += n;
+                size -= n;
+            }
+        }
+
+        /// Returns contiguous space for a block in the staging buffer, flushing the buffer if needed
+        /// @return Pointer to the space, or nullptr if the block does not fit into the buffer
+        /// @note The block is added to the output by Commit(); the space is valid until the next call of the writer.
+        [[nodiscard]]
+        uint8_t *Reserve(size_t size)
+        {
+            if(_capacity - _pos < size)
+                Flush();
+            return _capacity - _pos < size ? nullptr : _buffer + _pos;
+        }
+
+        /// Adds a block written into the space returned by Reserve() to the output
+        void Commit(size_t size) noexcept { _pos += size; }
+
+        /// Writes the buffered data to the file
+        /// @note With O_DIRECT, only whole aligned blocks are written; the tail remains buffered.
+        void Flush()
+        {
+            if(!_options.direct)
+                FlushBuffer();
+            else
+            {
+                const size_t aligned = _pos - _pos % alignment;
+                if(aligned)
+                {
+                    WriteOut(_buffer, aligned);
+                    std::memmove(_buffer, _buffer + aligned, _pos - aligned);
+                    _pos -= aligned;
+                }
+            }
+        }
+
+        /// Flushes the buffered data and waits until it reaches the storage device
+        void Sync()
+        {
+            Flush();
+            DataSync();
+        }
+
+        /// Flushes the buffered data and closes the file (if it was opened by the writer)
+        /// @note The writer is closed even if an exception is thrown; unwritten data is discarded.
+        void Close()
+        {
+            if(_fd < 0)
+                return;
+
+            try
+            {
+                Flush();
+
+                if(_options.direct && _pos)
+                    WriteTail();
+
+                if(_options.syncBytes || _options.syncPeriod.count())
+                    DataSync();
+            }
+            catch(...)
+            {
+                _pos = 0;
+                ReleaseFd();
+                throw;
+            }
+
+            if(!ReleaseFd())
+                utils::Throw<std::runtime_error>(std::format("close failed: {}", std::strerror(errno)));
+        }
+
+        /// Number of bytes passed to the writer
+        [[nodiscard]]
+        uint64_t Position() const noexcept { return _written + _pos; }
+
+        /// File descriptor
+        [[nodiscard]]
+        int GetFd() const noexcept { return _fd; }
+
+    private:
+        void Init()
+        {
+            if(_options.direct)
+            {
+                // O_DIRECT requires aligned file offsets
+                const off_t start = _options.offset < 0 ? ::lseek(_fd, 0, SEEK_CUR) : static_cast<off_t>(_options.offset);
+                if(start > 0 && start % static_cast<off_t>(alignment) != 0)
+                {
+                    if(_ownsFd)
+                        ::close(_fd);
+                    utils::Throw<std::invalid_argument>(std::format("O_DIRECT output starts at unaligned offset {}", start));
+                }
+            }
+
+            _capacity = (std::max(_options.bufferSize, alignment) + alignment - 1) / alignment * alignment;
+            _buffer = static_cast<uint8_t *>(std::aligned_alloc(alignment, _capacity));
+            if(!_buffer)
+            {
+                if(_ownsFd)
+                    ::close(_fd);
+                throw std::bad_alloc();
+            }
+            _lastSync = std::chrono::steady_clock::now();
+        }
+
+        /// Writes the unaligned tail of O_DIRECT output through the page cache
+        void WriteTail()
+        {
+            const int flags = ::fcntl(_fd, F_GETFL);
+            if(flags < 0 || ::fcntl(_fd, F_SETFL, flags & ~O_DIRECT) < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot disable O_DIRECT: {}", std::strerror(errno)));
+
+            // The flags of a descriptor owned by the caller are restored
+            if(_ownsFd)
+                WriteOut(_buffer, _pos);
+            else
+            {
+                try { WriteOut(_buffer, _pos); }
+                catch(...) { ::fcntl(_fd, F_SETFL, flags); throw; }
+
+                if(::fcntl(_fd, F_SETFL, flags) < 0)
+                    utils::Throw<std::runtime_error>(std::format("cannot restore O_DIRECT: {}", std::strerror(errno)));
+            }
+            _pos = 0;
+        }
+
+        /// Closes the descriptor if it is owned by the writer
+        /// @return false if close() failed (errno is set)
+        bool ReleaseFd() noexcept
+        {
+            const int fd = std::exchange(_fd, -1);
+            return !_ownsFd || ::close(fd) == 0;
+        }
+
+        void FlushBuffer()
+        {
+            if(_pos)
+            {
+                WriteOut(_buffer, _pos);
+                _pos = 0;
+            }
+        }
+
+        /// Writes the whole block, retrying interrupted and partial writes
+        /// @throw std::runtime_error if the write fails or makes no progress
+        void WriteOut(const uint8_t *data, size_t size)
+        {
+            while(size)
+            {
+                const ssize_t n = _options.offset < 0
+                                  ? ::write(_fd, data, size)
+                                  : ::pwrite(_fd, data, size, static_cast<off_t>(_options.offset + _written));
+                if(n < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    utils::Throw<std::runtime_error>(std::format("write failed: {}", std::strerror(errno)));
+                }
+
+                // A write of a nonzero size returning 0 would be retried forever
+                if(n == 0)
+                    utils::Throw<std::runtime_error>("write made no progress");
+
+                data += n;
+                size -= static_cast<size_t>(n);
+                _written += static_cast<uint64_t>(n);
+                _unsynced += static_cast<uint64_t>(n);
+            }
+
+            ApplySyncPolicy();
+        }
+
+        void ApplySyncPolicy()
+        {
+            if(_options.syncBytes && _unsynced >= _options.syncBytes)
+                DataSync();
+            else if(_options.syncPeriod.count() && std::chrono::steady_clock::now() - _lastSync >= _options.syncPeriod)
+                DataSync();
+        }
+
+        void DataSync()
+        {
+            if(::fdatasync(_fd) != 0)
+                utils::Throw<std::runtime_error>(std::format("fdatasync failed: {}", std::strerror(errno)));
+            _unsynced = 0;
+            _lastSync = std::chrono::steady_clock::now();
+        }
+
+        WriterOptions _options;
+
+        /// File descriptor
+        int _fd = -1;
+
+        /// The descriptor was opened by the writer and is closed by it
+        bool _ownsFd = false;
+
+        /// Staging buffer
+        uint8_t *_buffer = nullptr;
+        size_t _capacity = 0;
+        size_t _pos = 0;
+
+        /// Number of bytes written to the file
+        uint64_t _written = 0;
+
+        /// Number of bytes written since the last fdatasync
+        uint64_t _unsynced = 0;
+
+        std::chrono::steady_clock::time_point _lastSync;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
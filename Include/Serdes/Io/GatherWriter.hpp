@@ -0,0 +1,278 @@
+#ifndef SERDES_IO_GATHERWRITER_HPP
+#define SERDES_IO_GATHERWRITER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Scatter-gather (iovec) serialization
+
+    @details
+        GatherWriter collects serialized data as a list of iovec segments instead
+        of a single contiguous buffer. Small pieces of output (headers, length prefixes,
+        individual values) are coalesced into an internal staging buffer, while large
+        blocks of native-endian POD data, such as the contents of strings and vectors
+        of numbers, are referenced in place without copying. The resulting list is
+        passed to writev() or sendmsg():
+
+            GatherWriter writer;
+            SerializeTo<MySerdes>(writer.begin(), message);
+            writer.Writev(socketFd);
+
+        Referenced blocks are not copied, so the serialized values must remain alive
+        and unchanged until the iovec list has been written. Data that the serdes
+        produce on the fly (converted values of Custom serdes, elements of transform
+        views, encoded buffers) is written through an iterator switched to copying
+        mode (see CReferencingOutputIterator) and always lands in the staging buffer.
+
+        Writev() also works with non-blocking descriptors: when the descriptor is
+        not ready (EAGAIN), it waits for it with poll() and continues.
+
+        The implementation uses POSIX writev and is intended for Linux.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <stdexcept>
+#include <climits>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "../Core/Exception.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    //--------------------------------------------------------------------------
+    /// Writer producing a list of iovec segments
+    class GatherWriter
+    {
+    public:
+        /// Default minimum size of a block referenced in place
+        static constexpr size_t defaultThreshold = 4096;
+
+        /// Output iterator writing to the GatherWriter
+        class Iterator
+        {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            Iterator() = default;
+
+            explicit
+            Iterator(GatherWriter *writer) : _writer(writer) {}
+
+            Iterator &operator=(uint8_t byte)
+            {
+                _writer->Put(byte);
+                return *this;
+            }
+
+            Iterator &operator=(std::byte byte) { return *this = static_cast<uint8_t>(byte); }
+
+            Iterator &operator*() { return *this; }
+            Iterator &operator++() { return *this; }
+            Iterator operator++(int) { return *this; }
+
+            /// Writes a block of bytes (large blocks are referenced, not copied, unless the iterator copies blocks)
+            Iterator WriteBlock(const uint8_t *data, size_t size)
+            {
+                if(_copyBlocks)
+                    _writer->Copy(data, size);
+                else
+                    _writer->Write(data, size);
+                return *this;
+            }
+
+            /// The iterator copies written blocks
+            [[nodiscard]]
+            bool CopiesBlocks() const noexcept { return _copyBlocks; }
+
+            /// Returns an iterator to the same writer that copies (or references) written blocks
+            [[nodiscard]]
+            Iterator CopyBlocks(bool copy) const noexcept
+            {
+                Iterator iterator(_writer);
+                iterator._copyBlocks = copy;
+                return iterator;
+            }
+
+        private:
+            GatherWriter *_writer = nullptr;
+
+            /// Blocks are copied to the staging buffer regardless of their size
+            bool _copyBlocks = false;
+        };
+
+        /// @param threshold Minimum size of a block that is referenced in place rather than copied
+        explicit
+        GatherWriter(size_t threshold = defaultThreshold) : _threshold(threshold) {}
+
+        /// Returns an output iterator for serialization
+        [[nodiscard]]
+        Iterator begin() noexcept { return Iterator(this); }
+
+        /// Reserves space in the staging buffer
+        void Reserve(size_t size) { _staging.reserve(size); }
+
+        /// Writes a byte to the staging buffer
+        void Put(uint8_t byte) { _staging.push_back(byte); }
+
+        /// Copies a block of bytes to the staging buffer
+        void Copy(const uint8_t *data, size_t size) { _staging.insert(_staging.end(), data, data + size); }
+
+        /// Writes a block of bytes: large blocks are referenced, small ones are copied
+        /// @note A referenced block must remain valid until the iovec list has been written.
+        void Write(const uint8_t *data, size_t size)
+        {
+            if(size < _threshold)
+            {
+                Copy(data, size);
+                return;
+            }
+
+            CloseStaged();
+            _segments.push_back({data, 0, size});
+            _size += size;
+        }
+
+        /// Total number of bytes written
+        [[nodiscard]]
+        size_t Size() const noexcept { return _size + _staging.size() - _stagedEnd; }
+
+        /// Builds the iovec list
+        /// @note Pointers to the staging buffer are invalidated by subsequent writes.
+        [[nodiscard]]
+        std::vector<iovec> Iovecs() const
+        {
+            std::vector<iovec> iov;
+            iov.reserve(_segments.size() + 1);
+
+            for(const auto &segment: _segments)
+            {
+                const uint8_t *base = segment.data ? segment.data : _staging.data() + segment.offset;
+                iov.push_back({const_cast<uint8_t *>(base), segment.size});
+            }
+
+            if(_staging.size() > _stagedEnd)
+                iov.push_back({const_cast<uint8_t *>(_staging.data()) + _stagedEnd, _staging.size() - _stagedEnd});
+
+            return iov;
+        }
+
+        /// Writes all segments to a file descriptor, retrying interrupted and partial writes;
+        /// a non-blocking descriptor is waited for when it is not ready
+        /// @return Number of bytes written
+        /// @throw std::runtime_error on write errors
+        size_t Writev(int fd) const
+        {
+            std::vector<iovec> iov = Iovecs();
+            size_t written = 0;
+
+            for(size_t first = 0; first < iov.size();)
+            {
+                const int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+                const ssize_t n = ::writev(fd, iov.data() + first, count);
+                if(n < 0)
+                {
+                    if(errno == EINTR)
+                        continue;
+                    if(errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        WaitWritable(fd);
+                        continue;
+                    }
+                    utils::Throw<std::runtime_error>(std::format("writev failed: {}", std::strerror(errno)));
+                }
+
+                written += static_cast<size_t>(n);
+
+                // Skip fully written segments and adjust the partially written one
+                for(size_t rest = static_cast<size_t>(n); rest;)
+                {
+                    if(rest >= iov[first].iov_len)
+                        rest -= iov[first++].iov_len;
+                    else
+                    {
+                        iov[first].iov_base = static_cast<uint8_t *>(iov[first].iov_base) + rest;
+                        iov[first].iov_len -= rest;
+                        rest = 0;
+                    }
+                }
+
+                while(first < iov.size() && iov[first].iov_len == 0)
+                    first++;
+            }
+
+            return written;
+        }
+
+        /// Clears the writer for reuse (the staging buffer capacity is retained)
+        void Clear() noexcept
+        {
+            _staging.clear();
+            _segments.clear();
+            _stagedEnd = 0;
+            _size = 0;
+        }
+
+    private:
+        /// Waits until a non-blocking descriptor is ready for writing
+        static void WaitWritable(int fd)
+        {
+            pollfd pfd{fd, POLLOUT, 0};
+            while(::poll(&pfd, 1, -1) < 0)
+                if(errno != EINTR)
+                    utils::Throw<std::runtime_error>(std::format("poll failed: {}", std::strerror(errno)));
+        }
+
+        /// Segment of output: a referenced block (data != nullptr) or a part of the staging buffer
+        struct Segment
+        {
+            const uint8_t *data;
+            size_t offset;
+            size_t size;
+        };
+
+        /// Turns the bytes staged since the previous segment into a segment
+        void CloseStaged()
+        {
+            if(_staging.size() > _stagedEnd)
+            {
+                _segments.push_back({nullptr, _stagedEnd, _staging.size() - _stagedEnd});
+                _size += _staging.size() - _stagedEnd;
+                _stagedEnd = _staging.size();
+            }
+        }
+
+        /// Minimum size of a referenced block
+        size_t _threshold;
+
+        /// Staging buffer for small pieces of output
+        std::vector<uint8_t> _staging;
+
+        /// Closed segments
+        std::vector<Segment> _segments;
+
+        /// End of the staged bytes that already belong to closed segments
+        size_t _stagedEnd = 0;
+
+        /// Total size of closed segments
+        size_t _size = 0;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
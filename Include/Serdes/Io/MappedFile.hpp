@@ -0,0 +1,288 @@
+#ifndef SERDES_IO_MAPPEDFILE_HPP
+#define SERDES_IO_MAPPEDFILE_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Read-only memory-mapped file used as an input buffer
+
+    @details
+        MappedFile maps a whole file into memory and provides contiguous input
+        iterators (const uint8_t *) and spans that can be passed directly to
+        DeserializeFrom, Skip and other functions of the library. Pages are loaded
+        lazily by the operating system; access hints are passed with Advise().
+
+        Optionally, the mapping address can be aligned to the huge page size,
+        which allows the kernel to back the mapping with transparent huge pages.
+
+        The mapping is released by the destructor.
+
+        The implementation uses POSIX mmap/madvise and is intended for Linux.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <span>
+#include <string>
+#include <format>
+#include <utility>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../Core/Exception.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// Memory access hints (see madvise)
+    enum class Advice : uint8_t
+    {
+        Normal,     // no special treatment
+        Sequential, // aggressive readahead, pages may be freed soon after access
+        Random,     // readahead is disabled
+        WillNeed,   // pages are read ahead asynchronously
+        DontNeed,   // pages may be freed
+        HugePage    // enable transparent huge pages for the region
+    };
+
+    /// Mapping options
+    struct MapOptions
+    {
+        /// Access hint applied to the whole file after mapping
+        Advice advice = Advice::Sequential;
+
+        /// Read the whole file into memory during mapping (MAP_POPULATE)
+        bool populate = false;
+
+        /// Align the mapping address to the huge page size and apply Advice::HugePage
+        bool hugePageAligned = false;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Read-only memory-mapped file
+    class MappedFile
+    {
+    public:
+        /// Huge page size used for aligned mappings
+        static constexpr size_t hugePageSize = size_t(2) << 20;
+
+        MappedFile() = default;
+
+        /// Maps the file
+        /// @param path Path to the file
+        /// @param options Mapping options
+        /// @throw std::runtime_error if the file cannot be opened or mapped, or if
+        /// options.hugePageAligned is set and the platform does not support huge pages
+        explicit
+        MappedFile(const std::string &path, const MapOptions &options = {})
+        {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot open '{}': {}", path, std::strerror(errno)));
+
+            struct stat st;
+            if(::fstat(fd, &st) != 0)
+            {
+                const int err = errno;
+                ::close(fd);
+                utils::Throw<std::runtime_error>(std::format("cannot stat '{}': {}", path, std::strerror(err)));
+            }
+
+            if(options.hugePageAligned && ToNative(Advice::HugePage) < 0)
+            {
+                ::close(fd);
+                utils::Throw<std::runtime_error>(std::format("cannot map '{}': huge pages are not supported", path));
+            }
+
+            _size = static_cast<size_t>(st.st_size);
+
+            // Empty files are represented by an empty mapping
+            if(_size == 0)
+            {
+                ::close(fd);
+                _open = true;
+                return;
+            }
+
+            void *addr = options.hugePageAligned ? MapAligned(fd, options.populate) : MapPlain(fd, options.populate);
+            const int err = errno;
+            ::close(fd); // the mapping keeps its own reference to the file
+
+            if(addr == MAP_FAILED)
+            {
+                _size = 0;
+                utils::Throw<std::runtime_error>(std::format("cannot map '{}': {}", path, std::strerror(err)));
+            }
+
+            _data = static_cast<const uint8_t *>(addr);
+            _open = true;
+
+            if(options.hugePageAligned)
+                Advise(Advice::HugePage);
+            if(options.advice != Advice::Normal)
+                Advise(options.advice);
+        }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        MappedFile(MappedFile &&other) noexcept
+            : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0)),
+              _open(std::exchange(other._open, false)) {}
+
+        MappedFile &operator=(MappedFile &&other) noexcept
+        {
+            if(this != &other)
+            {
+                Close();
+                _data = std::exchange(other._data, nullptr);
+                _size = std::exchange(other._size, 0);
+                _open = std::exchange(other._open, false);
+            }
+            return *this;
+        }
+
+        ~MappedFile() { Close(); }
+
+        /// Unmaps the file
+        void Close() noexcept
+        {
+            if(_data)
+                ::munmap(const_cast<uint8_t *>(_data), _size);
+            _data = nullptr;
+            _size = 0;
+            _open = false;
+        }
+
+        /// @note An empty file is open, but has no mapping (data() returns nullptr)
+        [[nodiscard]]
+        bool IsOpen() const noexcept { return _open; }
+
+        /// Passes an access hint for a part of the file to the kernel
+        /// @param advice Access hint
+        /// @param offset Offset of the region (rounded down to the page boundary)
+        /// @param length Length of the region (by default, up to the end of the file)
+        /// @return false if the hint was rejected or is not supported by the platform
+        /// (errno is EINVAL); hints are advisory
+        bool Advise(Advice advice, size_t offset = 0, size_t length = SIZE_MAX) const noexcept
+        {
+            if(!_data || offset >= _size)
+                return false;
+
+            const int native = ToNative(advice);
+            if(native < 0)
+            {
+                errno = EINVAL;
+                return false;
+            }
+
+            const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const size_t begin = offset - offset % pageSize;
+            const size_t end = length >= _size - offset ? _size : offset + length;
+
+            return ::madvise(const_cast<uint8_t *>(_data) + begin, end - begin, native) == 0;
+        }
+
+        [[nodiscard]]
+        const uint8_t *data() const noexcept { return _data; }
+
+        [[nodiscard]]
+        size_t size() const noexcept { return _size; }
+
+        [[nodiscard]]
+        const uint8_t *begin() const noexcept { return _data; }
+
+        [[nodiscard]]
+        const uint8_t *end() const noexcept { return _data + _size; }
+
+        /// Returns the contents of the file as a span
+        [[nodiscard]]
+        std::span<const uint8_t> Span() const noexcept { return {_data, _size}; }
+
+        /// Returns a part of the file as a span
+        /// @throw std::out_of_range if the region exceeds the file
+        [[nodiscard]]
+        std::span<const uint8_t> Span(size_t offset, size_t length) const
+        {
+            if(offset > _size || length > _size - offset)
+                utils::Throw<std::out_of_range>(std::format("region [{}, +{}) exceeds file size {}", offset, length, _size));
+            return {_data + offset, length};
+        }
+
+    private:
+        void *MapPlain(int fd, bool populate) const noexcept
+        {
+            return ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+        }
+
+        /// Reserves an address range with room for alignment, maps the file at the aligned
+        /// address inside the range and releases the unused head and tail of the range
+        void *MapAligned(int fd, bool populate) const noexcept
+        {
+            const size_t reserved = _size + hugePageSize;
+            void *area = ::mmap(nullptr, reserved, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if(area == MAP_FAILED)
+                return MAP_FAILED;
+
+            const uintptr_t base = reinterpret_cast<uintptr_t>(area);
+            const uintptr_t aligned = (base + hugePageSize - 1) & ~(hugePageSize - 1);
+
+            void *addr = ::mmap(reinterpret_cast<void *>(aligned), _size, PROT_READ,
+                                MAP_PRIVATE | MAP_FIXED | (populate ? MAP_POPULATE : 0), fd, 0);
+            if(addr == MAP_FAILED)
+            {
+                const int err = errno;
+                ::munmap(area, reserved);
+                errno = err;
+                return MAP_FAILED;
+            }
+
+            const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            const uintptr_t mappedEnd = (aligned + _size + pageSize - 1) & ~(pageSize - 1);
+
+            if(aligned > base)
+                ::munmap(area, aligned - base);
+            if(base + reserved > mappedEnd)
+                ::munmap(reinterpret_cast<void *>(mappedEnd), base + reserved - mappedEnd);
+
+            return addr;
+        }
+
+        /// @return Native hint or -1 if the hint is not supported
+        static int ToNative(Advice advice) noexcept
+        {
+            switch(advice)
+            {
+                case Advice::Sequential: return MADV_SEQUENTIAL;
+                case Advice::Random:     return MADV_RANDOM;
+                case Advice::WillNeed:   return MADV_WILLNEED;
+                case Advice::DontNeed:   return MADV_DONTNEED;
+#ifdef MADV_HUGEPAGE
+                case Advice::HugePage:   return MADV_HUGEPAGE;
+#else
+                case Advice::HugePage:   return -1;
+#endif
+                default:                 return MADV_NORMAL;
+            }
+        }
+
+        /// Start of the mapping
+        const uint8_t *_data = nullptr;
+
+        /// File size
+        size_t _size = 0;
+
+        /// The file is mapped (or is empty)
+        bool _open = false;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
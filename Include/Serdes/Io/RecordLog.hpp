@@ -0,0 +1,649 @@
+#ifndef SERDES_IO_RECORDLOG_HPP
+#define SERDES_IO_RECORDLOG_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Append-only log of serialized records
+
+    @details
+        File format:
+
+            [header][record 0][record 1] ... [record n-1][index][trailer]
+
+        header  - magic (UInt64), format version (UInt32), index interval k (UInt32)
+        record  - payload length (UInt32), CRC-32C of the length and the payload (UInt32), payload
+        index   - file offsets (UInt64) of records 0, k, 2k, ...
+        trailer - number of records (UInt64), index offset (UInt64),
+                  CRC-32C of the index and the two preceding fields (UInt32), reserved (UInt32),
+                  footer magic (UInt64)
+
+        The index and the trailer (the footer) are written when the log is closed.
+        RecordLogWriter removes the footer when it reopens a log and continues
+        appending. If the log was not closed (a crash), the writer scans the
+        records, truncates the file at the first torn or corrupted record and
+        rebuilds the index.
+
+        Appended records become durable after Sync(), which uses group commit:
+        one thread (the leader) waits until the minimum interval since the
+        previous fdatasync has passed and then synchronizes the records of all
+        threads appended in the meantime; the other threads wait for the result.
+
+            RecordLogWriter log("events.log", {.syncInterval = std::chrono::milliseconds(2)});
+            log.Append<Event>(event);
+            log.Sync();
+
+        RecordLogReader maps the log and provides sequential scan and seeking by
+        record number through the sparse index:
+
+            RecordLogReader reader("events.log");
+            for(auto payload: reader)
+                ...
+            reader.Read<Event>(12345, event);
+
+        Logs of tuple records are filtered with DeserializeIf, which decodes only
+        the key fields of rejected records:
+
+            DeserializeIf<Event, 0>(reader, events, [](uint64_t id) { return id > 100; });
+
+        The implementation uses POSIX I/O and is intended for Linux.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <span>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <condition_variable>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../Core/Exception.hpp"
+#include "../Core/Concepts.hpp"
+#include "../Core/Helpers.hpp"
+#include "../Core/Typedefs.hpp"
+#include "../Core/Filter.hpp"
+#include "Crc32c.hpp"
+#include "FileWriter.hpp"
+#include "MappedFile.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// RecordLogWriter options
+    struct LogOptions
+    {
+        /// Number of records per index entry (used when a new log is created)
+        uint32_t indexInterval = 1024;
+
+        /// Minimum interval between fdatasync calls made by Sync()
+        std::chrono::microseconds syncInterval{0};
+
+        /// Size of the write buffer
+        size_t bufferSize = size_t(1) << 20;
+    };
+
+    namespace details
+    {
+        /// Record log file format
+        struct LogFormat
+        {
+            static constexpr uint64_t magic = 0x31474F4C53445253;       // "SRDSLOG1"
+            static constexpr uint64_t footerMagic = 0x3158444953445253; // "SRDSIDX1"
+            static constexpr uint32_t version = 1;
+
+            using HeaderSerdes = Tuple<UInt64, UInt32, UInt32>;
+            using PrefixSerdes = Tuple<UInt32, UInt32>;
+            using IndexSerdes = UInt64;
+            using TrailerSerdes = Tuple<UInt64, UInt64, UInt32, UInt32, UInt64>;
+
+            static constexpr uint32_t headerSize = HeaderSerdes::Sizeof();
+            static constexpr uint32_t prefixSize = PrefixSerdes::Sizeof();
+            static constexpr uint32_t trailerSize = TrailerSerdes::Sizeof();
+
+            /// Structure of the records of a log
+            struct Layout
+            {
+                uint32_t indexInterval = 0;
+
+                /// Number of records
+                uint64_t count = 0;
+
+                /// Offset of the end of the last record
+                uint64_t end = headerSize;
+
+                /// Offsets of records 0, indexInterval, 2 * indexInterval, ...
+                std::vector<uint64_t> index;
+
+                /// The log has a valid footer
+                bool closed = false;
+            };
+
+            /// Checksum of a record
+            static
+            uint32_t RecordCrc(const uint8_t *payload, uint32_t length) noexcept
+            {
+                uint8_t prefix[4];
+                UInt32::SerializeTo(prefix, length);
+                return Crc32c(payload, length, Crc32c(prefix, sizeof(prefix)));
+            }
+
+            /// Analyzes the contents of a log file
+            /// @throw std::runtime_error if the data does not start with a valid header
+            static
+            Layout Parse(const uint8_t *data, size_t size)
+            {
+                Layout layout;
+
+                uint64_t fileMagic = 0;
+                uint32_t fileVersion = 0;
+                if(size < headerSize)
+                    utils::Throw<std::runtime_error>("truncated record log header");
+
+                HeaderSerdes::DeserializeFrom(data, fileMagic, fileVersion, layout.indexInterval);
+                if(fileMagic != magic || fileVersion != version || layout.indexInterval == 0)
+                    utils::Throw<std::runtime_error>("invalid record log header");
+
+                if(!ParseFooter(data, size, layout))
+                    Scan(data, size, layout);
+
+                return layout;
+            }
+
+            /// Reads the footer of a closed log
+            static
+            bool ParseFooter(const uint8_t *data, size_t size, Layout &layout)
+            {
+                if(size < headerSize + trailerSize)
+                    return false;
+
+                const uint8_t *trailer = data + size - trailerSize;
+                uint64_t count = 0, indexOffset = 0, endMagic = 0;
+                uint32_t indexCrc = 0, reserved = 0;
+                TrailerSerdes::DeserializeFrom(trailer, count, indexOffset, indexCrc, reserved, endMagic);
+
+                if(endMagic != footerMagic || indexOffset < headerSize || indexOffset > size - trailerSize)
+                    return false;
+
+                const uint64_t entries = count / layout.indexInterval + (count % layout.indexInterval != 0);
+                if(indexOffset + entries * IndexSerdes::Sizeof() != size - trailerSize)
+                    return false;
+
+                // The checksum covers the index, the number of records and the index offset
+                if(Crc32c(data + indexOffset, size - indexOffset - trailerSize + 16) != indexCrc)
+                    return false;
+
+                layout.index.resize(entries);
+                const uint8_t *entry = data + indexOffset;
+                for(uint64_t &offset: layout.index)
+                    entry = IndexSerdes::DeserializeFrom(entry, offset);
+
+                layout.count = count;
+                layout.end = indexOffset;
+                layout.closed = true;
+                return true;
+            }
+
+            /// Scans the records up to the first torn or corrupted record
+            static
+            void Scan(const uint8_t *data, size_t size, Layout &layout)
+            {
+                uint64_t pos = headerSize;
+                while(size - pos >= prefixSize)
+                {
+                    uint32_t length = 0, crc = 0;
+                    PrefixSerdes::DeserializeFrom(data + pos, length, crc);
+
+                    if(size - pos - prefixSize < length || RecordCrc(data + pos + prefixSize, length) != crc)
+                        break;
+
+                    if(layout.count % layout.indexInterval == 0)
+                        layout.index.push_back(pos);
+                    layout.count++;
+                    pos += prefixSize + length;
+                }
+                layout.end = pos;
+            }
+        };
+    }
+
+    //--------------------------------------------------------------------------
+    /// Writer of a record log; Append() and Sync() may be called from several threads
+    class RecordLogWriter
+    {
+        using Format = details::LogFormat;
+
+    public:
+        /// Opens a log for appending, creating it if it does not exist
+        /// @note If the log was not closed, the file is truncated at the first torn or corrupted record.
+        /// @throw std::runtime_error if the file cannot be opened or is not a record log
+        explicit
+        RecordLogWriter(const std::string &path, const LogOptions &options = {})
+            : _options(options)
+        {
+            _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if(_fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot open '{}': {}", path, std::strerror(errno)));
+
+            try
+            {
+                Open(path);
+            }
+            catch(...)
+            {
+                ::close(_fd);
+                throw;
+            }
+        }
+
+        RecordLogWriter(const RecordLogWriter &) = delete;
+        RecordLogWriter &operator=(const RecordLogWriter &) = delete;
+
+        /// Writes the footer and closes the log
+        /// @note Errors are ignored; call Close() explicitly to handle them.
+        ~RecordLogWriter()
+        {
+            try { Close(); } catch(...) {}
+        }
+
+        /// Appends a record serialized with the given serdes
+        /// @return Number of the record
+        /// @throw std::length_error if the record size exceeds the allowed limit
+        template<CSerdes ...TSerdes, typename ...TValues>
+        uint64_t Append(const TValues &...values)
+        {
+            using Serdes = SerdesT<TSerdes...>;
+
+            const uint32_t size = Serdes::Sizeof(values...);
+            if(size == WRONG_SIZE)
+                utils::Throw<std::length_error>("record size exceeds the allowed limit");
+
+            std::lock_guard lock(_mutex);
+            CheckOpen();
+
+            // The record is assembled in the write buffer; only records that do not fit are staged
+            if(uint8_t *record = _writer->Reserve(Format::prefixSize + size_t(size)))
+            {
+                uint8_t *payload = record + Format::prefixSize;
+                Serdes::SerializeTo(payload, values...);
+                Format::PrefixSerdes::SerializeTo(record, size, Format::RecordCrc(payload, size));
+                _writer->Commit(Format::prefixSize + size_t(size));
+                return AddRecord(size);
+            }
+
+            _scratch.resize(size);
+            Serdes::SerializeTo(_scratch.data(), values...);
+            return WriteRecord(_scratch);
+        }
+
+        /// Appends a record with an already serialized payload
+        /// @return Number of the record
+        /// @throw std::length_error if the record size exceeds the allowed limit
+        uint64_t AppendBytes(std::span<const uint8_t> payload)
+        {
+            if(payload.size() >= WRONG_SIZE)
+                utils::Throw<std::length_error>("record size exceeds the allowed limit");
+
+            std::lock_guard lock(_mutex);
+            CheckOpen();
+            return WriteRecord(payload);
+        }
+
+        /// Waits until all records appended before the call are durable
+        /// @note Concurrent calls are combined into a single fdatasync (group commit),
+        /// and fdatasync is called at most once per LogOptions::syncInterval.
+        /// @throw std::runtime_error if the data cannot be written or synchronized
+        void Sync()
+        {
+            std::unique_lock lock(_mutex);
+            const uint64_t target = _count;
+
+            while(_durable < target)
+            {
+                if(_syncing)
+                {
+                    _synced.wait(lock);
+                    continue;
+                }
+
+                // This thread becomes the leader; records appended while it waits are included
+                _syncing = true;
+                const auto next = _lastSync + _options.syncInterval;
+                if(std::chrono::steady_clock::now() < next)
+                {
+                    lock.unlock();
+                    std::this_thread::sleep_until(next);
+                    lock.lock();
+                }
+
+                int err = 0;
+                uint64_t covered = _count;
+                try
+                {
+                    _writer->Flush();
+                }
+                catch(...)
+                {
+                    _syncing = false;
+                    _synced.notify_all();
+                    throw;
+                }
+
+                lock.unlock();
+                if(::fdatasync(_fd) != 0)
+                    err = errno;
+                lock.lock();
+
+                _syncing = false;
+                _lastSync = std::chrono::steady_clock::now();
+                if(!err)
+                    _durable = std::max(_durable, covered);
+                _synced.notify_all();
+
+                if(err)
+                    utils::Throw<std::runtime_error>(std::format("fdatasync failed: {}", std::strerror(err)));
+            }
+        }
+
+        /// Writes the index and the footer, synchronizes and closes the file
+        void Close()
+        {
+            std::unique_lock lock(_mutex);
+            if(_fd < 0)
+                return;
+
+            _synced.wait(lock, [this] { return !_syncing; });
+
+            // Checksum of the index and of the first two trailer fields
+            std::vector<uint8_t> footer(_index.size() * Format::IndexSerdes::Sizeof() + Format::trailerSize);
+            auto pos = footer.begin();
+            for(uint64_t offset: _index)
+                pos = Format::IndexSerdes::SerializeTo(pos, offset);
+            pos = Tuple<UInt64, UInt64>::SerializeTo(pos, _count, _end);
+            const uint32_t crc = Crc32c(footer.data(), static_cast<size_t>(pos - footer.begin()));
+            Tuple<UInt32, UInt32, UInt64>::SerializeTo(pos, crc, 0u, Format::footerMagic);
+
+            // The descriptor is closed even if writing the footer or synchronizing fails
+            const int fd = std::exchange(_fd, -1);
+            try
+            {
+                _writer->Write(footer.data(), footer.size());
+                _writer->Close();
+                _writer.reset();
+            }
+            catch(...)
+            {
+                _writer.reset();
+                ::close(fd);
+                throw;
+            }
+
+            // The first error is reported
+            const int syncError = ::fdatasync(fd) != 0 ? errno : 0;
+            const int closeError = ::close(fd) != 0 ? errno : 0;
+            if(syncError || closeError)
+                utils::Throw<std::runtime_error>(std::format("cannot close the record log: {}",
+                                                             std::strerror(syncError ? syncError : closeError)));
+            _durable = _count;
+        }
+
+        /// Number of records in the log
+        [[nodiscard]]
+        uint64_t Size() const
+        {
+            std::lock_guard lock(_mutex);
+            return _count;
+        }
+
+        /// Number of records known to be durable
+        [[nodiscard]]
+        uint64_t DurableSize() const
+        {
+            std::lock_guard lock(_mutex);
+            return _durable;
+        }
+
+        /// Number of bytes of torn or corrupted records removed when the log was opened
+        [[nodiscard]]
+        uint64_t TruncatedBytes() const noexcept { return _truncated; }
+
+    private:
+        void Open(const std::string &path)
+        {
+            struct stat st;
+            if(::fstat(_fd, &st) != 0)
+                utils::Throw<std::runtime_error>(std::format("cannot stat '{}': {}", path, std::strerror(errno)));
+
+            Format::Layout layout;
+            if(st.st_size == 0)
+            {
+                if(_options.indexInterval == 0)
+                    utils::Throw<std::invalid_argument>("index interval must be positive");
+
+                uint8_t header[Format::headerSize];
+                Format::HeaderSerdes::SerializeTo(header, Format::magic, Format::version, _options.indexInterval);
+                if(::pwrite(_fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) || ::fdatasync(_fd) != 0)
+                    utils::Throw<std::runtime_error>(std::format("cannot write '{}': {}", path, std::strerror(errno)));
+                layout.indexInterval = _options.indexInterval;
+            }
+            else
+            {
+                const MappedFile file(path, {.advice = Advice::Sequential});
+                layout = Format::Parse(file.data(), file.size());
+
+                // The footer is removed; records are appended after the last valid record
+                if(static_cast<uint64_t>(st.st_size) != layout.end)
+                {
+                    if(!layout.closed)
+                        _truncated = static_cast<uint64_t>(st.st_size) - layout.end;
+                    if(::ftruncate(_fd, static_cast<off_t>(layout.end)) != 0 || ::fdatasync(_fd) != 0)
+                        utils::Throw<std::runtime_error>(std::format("cannot truncate '{}': {}", path, std::strerror(errno)));
+                }
+            }
+
+            _interval = layout.indexInterval;
+            _count = layout.count;
+            _durable = layout.count;
+            _end = layout.end;
+            _index = std::move(layout.index);
+            _lastSync = std::chrono::steady_clock::now() - _options.syncInterval;
+
+            _writer.emplace(_fd, WriterOptions{.bufferSize = _options.bufferSize, .offset = static_cast<int64_t>(_end)});
+        }
+
+        void CheckOpen() const
+        {
+            if(_fd < 0)
+                utils::Throw<std::logic_error>("the record log is closed");
+        }
+
+        /// Writes a record; the payload is copied into the write buffer or written directly if it is large
+        uint64_t WriteRecord(std::span<const uint8_t> payload)
+        {
+            const uint32_t size = static_cast<uint32_t>(payload.size());
+            uint8_t prefix[Format::prefixSize];
+            Format::PrefixSerdes::SerializeTo(prefix, size, Format::RecordCrc(payload.data(), size));
+            _writer->Write(prefix, sizeof(prefix));
+            _writer->Write(payload.data(), size);
+            return AddRecord(size);
+        }
+
+        /// Accounts for a record written to the writer
+        uint64_t AddRecord(uint32_t size)
+        {
+            if(_count % _interval == 0)
+                _index.push_back(_end);
+            _end += Format::prefixSize + size;
+            return _count++;
+        }
+
+        LogOptions _options;
+        int _fd = -1;
+        std::optional<FileWriter> _writer;
+
+        mutable std::mutex _mutex;
+        std::condition_variable _synced;
+        bool _syncing = false;
+        std::chrono::steady_clock::time_point _lastSync;
+
+        uint32_t _interval = 0;
+        uint64_t _count = 0;
+        uint64_t _durable = 0;
+        uint64_t _end = 0;
+        uint64_t _truncated = 0;
+        std::vector<uint64_t> _index;
+
+        /// Payload of a record that does not fit into the write buffer
+        std::vector<uint8_t> _scratch;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Reader of a record log mapped into memory
+    class RecordLogReader
+    {
+        using Format = details::LogFormat;
+
+    public:
+        /// Forward iterator over the payloads of the records
+        class Iterator
+        {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::span<const uint8_t>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::span<const uint8_t>;
+
+            Iterator() = default;
+
+            Iterator(const RecordLogReader *reader, uint64_t offset) : _reader(reader), _offset(offset) {}
+
+            /// Payload of the record
+            /// @throw std::runtime_error if the record checksum does not match
+            std::span<const uint8_t> operator*() const { return _reader->RecordAt(_offset); }
+
+            Iterator &operator++()
+            {
+                uint32_t length = 0;
+                UInt32::DeserializeFrom(_reader->_file.data() + _offset, length);
+                _offset += Format::prefixSize + length;
+                return *this;
+            }
+
+            Iterator operator++(int)
+            {
+                Iterator it = *this;
+                ++*this;
+                return it;
+            }
+
+            bool operator==(const Iterator &other) const noexcept { return _offset == other._offset; }
+
+            /// Offset of the record in the file
+            [[nodiscard]]
+            uint64_t Offset() const noexcept { return _offset; }
+
+        private:
+            const RecordLogReader *_reader = nullptr;
+            uint64_t _offset = 0;
+        };
+
+        /// Maps a record log
+        /// @param verify Verify record checksums on access. Records of a log that was not
+        /// closed are verified when it is opened, since the index is rebuilt by scanning.
+        /// @throw std::runtime_error if the file cannot be mapped or is not a record log
+        explicit
+        RecordLogReader(const std::string &path, bool verify = true)
+            : _file(path, {.advice = Advice::Sequential})
+            , _layout(Format::Parse(_file.data(), _file.size()))
+            , _verify(verify && _layout.closed)
+        {}
+
+        /// Number of records
+        [[nodiscard]]
+        uint64_t Size() const noexcept { return _layout.count; }
+
+        /// The log was closed and has a valid footer
+        [[nodiscard]]
+        bool IsClosed() const noexcept { return _layout.closed; }
+
+        [[nodiscard]]
+        Iterator begin() const noexcept { return Iterator(this, Format::headerSize); }
+
+        [[nodiscard]]
+        Iterator end() const noexcept { return Iterator(this, _layout.end); }
+
+        /// Returns an iterator to a record, using the sparse index
+        /// @throw std::out_of_range if there is no record with the given number
+        [[nodiscard]]
+        Iterator Seek(uint64_t number) const
+        {
+            if(number >= _layout.count)
+                utils::Throw<std::out_of_range>(std::format("record {} is out of range ({} records)", number, _layout.count));
+
+            Iterator it(this, _layout.index[number / _layout.indexInterval]);
+            for(uint64_t i = number % _layout.indexInterval; i; i--)
+                ++it;
+            return it;
+        }
+
+        /// Payload of a record
+        [[nodiscard]]
+        std::span<const uint8_t> operator[](uint64_t number) const { return *Seek(number); }
+
+        /// Deserializes a record
+        template<CSerdes ...TSerdes, typename ...TValues>
+        void Read(uint64_t number, TValues &...values) const
+        {
+            SerdesT<TSerdes...>::DeserializeFrom((*this)[number].data(), values...);
+        }
+
+    private:
+        std::span<const uint8_t> RecordAt(uint64_t offset) const
+        {
+            const uint8_t *prefix = _file.data() + offset;
+            uint32_t length = 0, crc = 0;
+            Format::PrefixSerdes::DeserializeFrom(prefix, length, crc);
+
+            const uint8_t *payload = prefix + Format::prefixSize;
+            if(_verify && Format::RecordCrc(payload, length) != crc)
+                utils::Throw<std::runtime_error>(std::format("checksum mismatch in the record at offset {}", offset));
+            return {payload, length};
+        }
+
+        MappedFile _file;
+        Format::Layout _layout;
+        bool _verify;
+    };
+
+    //--------------------------------------------------------------------------
+    /// Deserializes the records of a log accepted by a predicate
+    /// @tparam TSerdes Tuple serdes of the records
+    /// @tparam keys Indices of the record fields passed to the predicate
+    /// @param reader Log whose records were appended with TSerdes
+    /// @param container Container to which the accepted records are appended
+    /// @param predicate Callable entity taking the key fields (in the order of keys) and returning bool
+    /// @note Only the key fields of rejected records are decoded, as in DeserializeIf for ranges.
+    template<CSerdes TSerdes, size_t ...keys, typename TContainer, typename TPredicate>
+    requires (sizeof...(keys) > 0 && TSerdes::GetTypeId() == TypeId::Tuple)
+    void DeserializeIf(const RecordLogReader &reader, TContainer &container, TPredicate predicate)
+    {
+        for(std::span<const uint8_t> payload: reader)
+            details::DeserializeRecordIf<TSerdes, keys...>(payload.data(), container, predicate);
+    }
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
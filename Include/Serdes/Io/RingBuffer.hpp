@@ -0,0 +1,437 @@
+#ifndef SERDES_IO_RINGBUFFER_HPP
+#define SERDES_IO_RINGBUFFER_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Lock-free ring buffer of serialized records
+
+    @details
+        RingBuffer transfers variable-length records from one producer (SPSC) or
+        several producers (MPSC) to one consumer without locks and without
+        intermediate copies: a producer reserves space for a record, serializes
+        the value directly into the ring and commits the record; the consumer
+        deserializes the record or views it in place and releases it.
+
+            RingBuffer<RingProducers::Single> ring(1 << 20);
+
+            // producer thread
+            ring.Write<MySerdes>(message);
+
+            // consumer thread
+            if(auto record = ring.Peek())
+            {
+                Process(record.Data());
+                ring.Release(record);
+            }
+
+        Memory layout: a control block with the producer and consumer positions
+        on separate cache lines, followed by the data area, whose size is a power
+        of two. Every record starts at an 8-byte aligned position with an 8-byte
+        header followed by the payload:
+
+            [state and length: 4 bytes][extent: 4 bytes][payload, padded to 8 bytes]
+
+        The extent is the space occupied by the record, which may exceed the
+        committed length when less than the reserved space is used. The state
+        bits of the header mark the record as committed (bit 31) or as
+        padding (bit 30). A record never wraps around the end of the data area;
+        if the contiguous space before the end is too small, it is filled with
+        a padding record and the record is placed at the beginning.
+
+        The consumer zeroes released records, so uncommitted headers always read
+        as zero. The ring can be placed in memory shared between processes
+        (see SharedRing.hpp), since it contains no pointers.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <span>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <new>
+#include <bit>
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include "../Core/Concepts.hpp"
+#include "../Core/Helpers.hpp"
+#include "../Core/Exception.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// Number of producers of a ring buffer
+    enum class RingProducers : uint8_t
+    {
+        Single,  // one producer thread (SPSC)
+        Multiple // any number of producer threads (MPSC)
+    };
+
+    /// Control block of a ring buffer placed at the beginning of its memory
+    struct RingControl
+    {
+        static constexpr size_t cacheLine = 64;
+        static constexpr uint32_t magic = 0x52494E47; // "RING"
+
+        /// Position of the next reservation (producers)
+        alignas(cacheLine) std::atomic<uint64_t> head;
+
+        /// Position of the first unreleased record (consumer)
+        alignas(cacheLine) std::atomic<uint64_t> tail;
+
+        /// Notification counter used as a futex word by transports that wait for records
+        alignas(cacheLine) std::atomic<uint32_t> sequence;
+
+        /// Number of consumers waiting on the notification counter
+        std::atomic<uint32_t> waiters;
+
+        /// Size of the data area
+        alignas(cacheLine) uint64_t capacity;
+        uint32_t signature;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free);
+
+    //--------------------------------------------------------------------------
+    /// Lock-free ring buffer of variable-length records
+    /// @tparam producers Single (SPSC) or multiple (MPSC) producers
+    template<RingProducers producers>
+    class RingBuffer
+    {
+    public:
+        /// Size of a record header
+        static constexpr uint32_t headerSize = 8;
+
+        /// Maximum size of a record payload
+        static constexpr uint32_t maxRecordSize = (1u << 30) - 1;
+
+        /// Space reserved for a record by a producer
+        class Reservation
+        {
+        public:
+            Reservation() = default;
+
+            explicit operator bool() const noexcept { return _header != nullptr; }
+
+            /// Space for the payload
+            [[nodiscard]]
+            std::span<uint8_t> Data() const noexcept { return {_header + headerSize, _capacity}; }
+
+            [[nodiscard]]
+            uint8_t *begin() const noexcept { return _header + headerSize; }
+
+        private:
+            friend class RingBuffer;
+
+            Reservation(uint8_t *header, uint32_t capacity) noexcept : _header(header), _capacity(capacity) {}
+
+            uint8_t *_header = nullptr;
+            uint32_t _capacity = 0;
+        };
+
+        /// Committed record viewed by the consumer
+        class Record
+        {
+        public:
+            Record() = default;
+
+            explicit operator bool() const noexcept { return _header != nullptr; }
+
+            /// Payload of the record
+            [[nodiscard]]
+            std::span<const uint8_t> Data() const noexcept { return {_header + headerSize, _size}; }
+
+            [[nodiscard]]
+            const uint8_t *begin() const noexcept { return _header + headerSize; }
+
+            [[nodiscard]]
+            const uint8_t *end() const noexcept { return _header + headerSize + _size; }
+
+        private:
+            friend class RingBuffer;
+
+            Record(uint8_t *header, uint32_t size, uint32_t extent) noexcept
+                : _header(header), _size(size), _extent(extent) {}
+
+            uint8_t *_header = nullptr;
+            uint32_t _size = 0;
+
+            /// Space occupied in the ring, including the header
+            uint32_t _extent = 0;
+        };
+
+        /// Size of the memory required for a ring with the given data capacity
+        [[nodiscard]] static constexpr
+        size_t RequiredSize(size_t capacity) noexcept { return sizeof(RingControl) + capacity; }
+
+        /// Creates a ring buffer owning its memory
+        /// @param capacity Size of the data area, a power of two of at least 64 bytes
+        explicit RingBuffer(size_t capacity)
+            : _owned(static_cast<uint8_t *>(::operator new(RequiredSize(capacity), std::align_val_t{RingControl::cacheLine})))
+        {
+            Attach(_owned.get(), RequiredSize(capacity), true);
+        }
+
+        /// Creates a ring buffer view over external memory
+        /// @param memory Memory aligned to a cache line, of RequiredSize(capacity) bytes
+        /// @param size Size of the memory
+        /// @param create true to initialize the ring, false to attach to a ring initialized by another view
+        /// @throw std::invalid_argument if the memory does not hold a valid ring
+        RingBuffer(void *memory, size_t size, bool create)
+        {
+            Attach(static_cast<uint8_t *>(memory), size, create);
+        }
+
+        RingBuffer(const RingBuffer &) = delete;
+        RingBuffer &operator=(const RingBuffer &) = delete;
+
+        /// Size of the data area
+        [[nodiscard]]
+        size_t Capacity() const noexcept { return _mask + 1; }
+
+        /// Largest payload that can be reserved
+        [[nodiscard]]
+        uint32_t MaxRecordSize() const noexcept
+        {
+            return static_cast<uint32_t>(std::min<uint64_t>(maxRecordSize, Capacity() / 2 - headerSize));
+        }
+
+        //----------------------------------------------------------------------
+        // Producer side
+
+        /// Reserves space for a record payload
+        /// @return Empty reservation if the ring does not have enough free space
+        /// @throw std::length_error if the size exceeds MaxRecordSize()
+        [[nodiscard]]
+        Reservation Reserve(uint32_t size)
+        {
+            if(size > MaxRecordSize())
+                utils::Throw<std::length_error>(std::format("record size {} exceeds the limit {}", size, MaxRecordSize()));
+
+            const uint32_t extent = Extent(size);
+            uint64_t head = _control->head.load(std::memory_order_relaxed);
+            uint64_t offset;
+            uint64_t padding;
+
+            while(true)
+            {
+                offset = head & _mask;
+                const uint64_t contiguous = Capacity() - offset;
+                padding = contiguous < extent ? contiguous : 0;
+
+                if(head + padding + extent - CachedTail() > Capacity())
+                {
+                    // Reload the consumer position and check again
+                    if(head + padding + extent - RefreshTail() > Capacity())
+                        return {};
+                }
+
+                if constexpr (producers == RingProducers::Single)
+                {
+                    _control->head.store(head + padding + extent, std::memory_order_relaxed);
+                    break;
+                }
+                else if(_control->head.compare_exchange_weak(head, head + padding + extent, std::memory_order_relaxed))
+                    break;
+            }
+
+            if(padding)
+            {
+                Header(offset).store(committedBit | paddingBit, std::memory_order_release);
+                offset = 0;
+            }
+
+            uint8_t *header = _data + offset;
+            std::memcpy(header + 4, &extent, sizeof(extent));
+            return {header, size};
+        }
+
+        /// Publishes a reserved record
+        /// @param size Size of the serialized payload, at most the reserved size
+        void Commit(const Reservation &reservation, uint32_t size)
+        {
+            if(size > reservation._capacity)
+                utils::Throw<std::length_error>("committed size exceeds the reserved size");
+
+            std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(reservation._header))
+                .store(committedBit | size, std::memory_order_release);
+        }
+
+        /// Publishes a reserved record with the reserved size
+        void Commit(const Reservation &reservation) { Commit(reservation, reservation._capacity); }
+
+        /// Serializes values directly into the ring
+        /// @return false if the ring does not have enough free space
+        template<CSerdes ...TSerdes, typename ...TValues>
+        bool Write(const TValues &...values)
+        {
+            using Serdes = SerdesT<TSerdes...>;
+
+            uint32_t size;
+            if constexpr (Serdes::GetBufferType() == BufferType::Static)
+                size = Serdes::Sizeof();
+            else
+                size = Serdes::Sizeof(values...);
+
+            const Reservation reservation = Reserve(size);
+            if(!reservation)
+                return false;
+
+            uint8_t *end = Serdes::SerializeTo(reservation.begin(), values...);
+            Commit(reservation, static_cast<uint32_t>(end - reservation.begin()));
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // Consumer side
+
+        /// Returns the next committed record without removing it
+        /// @return Empty record if there are no committed records
+        [[nodiscard]]
+        Record Peek()
+        {
+            while(true)
+            {
+                const uint64_t tail = _control->tail.load(std::memory_order_relaxed);
+                const uint64_t offset = tail & _mask;
+                const uint32_t state = Header(offset).load(std::memory_order_acquire);
+
+                if(!(state & committedBit))
+                    return {};
+
+                if(state & paddingBit)
+                {
+                    // Padding up to the end of the data area
+                    Header(offset).store(0, std::memory_order_relaxed);
+                    _control->tail.store(tail + (Capacity() - offset), std::memory_order_release);
+                    continue;
+                }
+
+                uint8_t *header = _data + offset;
+                uint32_t extent;
+                std::memcpy(&extent, header + 4, sizeof(extent));
+                return {header, state & sizeMask, extent};
+            }
+        }
+
+        /// Removes a record returned by Peek()
+        void Release(const Record &record)
+        {
+            // Free space is kept zeroed, so uncommitted headers read as zero
+            std::memset(record._header + 4, 0, record._extent - 4);
+            std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(record._header)).store(0, std::memory_order_relaxed);
+
+            const uint64_t tail = _control->tail.load(std::memory_order_relaxed);
+            _control->tail.store(tail + record._extent, std::memory_order_release);
+        }
+
+        /// Deserializes and removes the next record
+        /// @return false if there are no committed records
+        template<CSerdes ...TSerdes, typename ...TValues>
+        bool Read(TValues &...values)
+        {
+            const Record record = Peek();
+            if(!record)
+                return false;
+
+            SerdesT<TSerdes...>::DeserializeFrom(record.begin(), values...);
+            Release(record);
+            return true;
+        }
+
+        /// Checks whether there are no unreleased records
+        /// @note The result may be outdated immediately if other threads use the ring.
+        [[nodiscard]]
+        bool Empty() const noexcept
+        {
+            return _control->head.load(std::memory_order_acquire) == _control->tail.load(std::memory_order_acquire);
+        }
+
+    protected:
+        /// Control block (for derived transports that add waiting)
+        [[nodiscard]]
+        RingControl &Control() const noexcept { return *_control; }
+
+    private:
+        static constexpr uint32_t committedBit = 1u << 31;
+        static constexpr uint32_t paddingBit = 1u << 30;
+        static constexpr uint32_t sizeMask = paddingBit - 1;
+
+        struct Deleter
+        {
+            void operator()(uint8_t *memory) const noexcept
+            {
+                ::operator delete(memory, std::align_val_t{RingControl::cacheLine});
+            }
+        };
+
+        void Attach(uint8_t *memory, size_t size, bool create)
+        {
+            if(reinterpret_cast<uintptr_t>(memory) % RingControl::cacheLine)
+                utils::Throw<std::invalid_argument>("ring memory is not aligned to a cache line");
+
+            const size_t capacity = size > sizeof(RingControl) ? size - sizeof(RingControl) : 0;
+            if(capacity < 64 || !std::has_single_bit(capacity))
+                utils::Throw<std::invalid_argument>(std::format("ring capacity {} is not a power of two of at least 64", capacity));
+
+            _control = reinterpret_cast<RingControl *>(memory);
+            _data = memory + sizeof(RingControl);
+            _mask = capacity - 1;
+
+            if(create)
+            {
+                std::memset(_data, 0, capacity);
+                _control = new(memory) RingControl{};
+                _control->capacity = capacity;
+                _control->signature = RingControl::magic;
+            }
+            else if(_control->signature != RingControl::magic || _control->capacity != capacity)
+                utils::Throw<std::invalid_argument>("memory does not contain a ring of the expected capacity");
+        }
+
+        /// Space occupied by a record with the given payload size
+        [[nodiscard]] static constexpr
+        uint32_t Extent(uint32_t size) noexcept { return headerSize + ((size + 7) & ~7u); }
+
+        [[nodiscard]]
+        std::atomic_ref<uint32_t> Header(uint64_t offset) const noexcept
+        {
+            return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(_data + offset));
+        }
+
+        /// Consumer position known to the producer
+        [[nodiscard]]
+        uint64_t CachedTail() noexcept
+        {
+            if constexpr (producers == RingProducers::Single)
+                return _cachedTail;
+            else
+                return _control->tail.load(std::memory_order_acquire);
+        }
+
+        uint64_t RefreshTail() noexcept
+        {
+            const uint64_t tail = _control->tail.load(std::memory_order_acquire);
+            if constexpr (producers == RingProducers::Single)
+                _cachedTail = tail;
+            return tail;
+        }
+
+        std::unique_ptr<uint8_t, Deleter> _owned;
+        RingControl *_control = nullptr;
+        uint8_t *_data = nullptr;
+        uint64_t _mask = 0;
+
+        /// Last consumer position read by the single producer
+        uint64_t _cachedTail = 0;
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,315 @@
+#ifndef SERDES_IO_SHAREDRING_HPP
+#define SERDES_IO_SHAREDRING_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Ring buffer in shared memory for messaging between processes
+
+    @details
+        SharedRing places a RingBuffer (see RingBuffer.hpp) in memory shared
+        between processes on the same host: a named POSIX shared memory object
+        (shm_open) or an anonymous memfd whose descriptor is passed to the other
+        process (for example, over a Unix socket with SCM_RIGHTS). Producers
+        serialize directly into the shared memory; the consumer deserializes
+        records or views them in place.
+
+            // process A
+            auto ring = SharedRing<RingProducers::Single>::Create("/feed", 1 << 24);
+            ring.Write<Quote>(quote);
+
+            // process B
+            auto ring = SharedRing<RingProducers::Single>::Open("/feed");
+            if(auto record = ring.Wait(std::chrono::milliseconds(100)))
+            {
+                auto quote = DeserializeFrom<Quote>(record.begin());
+                ring.Release(record);
+            }
+
+        A waiting consumer first spins, then sleeps on a futex in the control
+        block. Producers issue the wake-up system call only when a consumer is
+        sleeping. With WaitMode::BusyPoll the consumer never sleeps, so neither
+        side makes system calls.
+
+        The implementation uses Linux-specific memfd_create and futex.
+
+    @todo
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <string>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <format>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "../Core/Exception.hpp"
+#include "RingBuffer.hpp"
+
+//------------------------------------------------------------------------------
+namespace serdes
+{
+    /// Waiting strategy of a consumer
+    enum class WaitMode : uint8_t
+    {
+        Adaptive, // spin for a short time, then sleep on a futex
+        BusyPoll  // spin until a record arrives or the timeout expires
+    };
+
+    namespace details
+    {
+        /// Shared mapping of a file descriptor
+        class SharedMemory
+        {
+        protected:
+            /// @param fd File descriptor owned by the object
+            /// @param size Size to set for the file (0 - map the current size)
+            /// @throw std::runtime_error if the file cannot be resized or mapped
+            SharedMemory(int fd, size_t size) : _fd(fd)
+            {
+                if(size)
+                {
+                    if(::ftruncate(fd, static_cast<off_t>(size)) != 0)
+                        Fail("cannot resize shared memory");
+                }
+                else
+                {
+                    struct stat st;
+                    if(::fstat(fd, &st) != 0)
+                        Fail("cannot stat shared memory");
+                    size = static_cast<size_t>(st.st_size);
+                }
+
+                void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if(addr == MAP_FAILED)
+                    Fail("cannot map shared memory");
+
+                _addr = addr;
+                _size = size;
+            }
+
+            SharedMemory(const SharedMemory &) = delete;
+            SharedMemory &operator=(const SharedMemory &) = delete;
+
+            ~SharedMemory()
+            {
+                ::munmap(_addr, _size);
+                ::close(_fd);
+            }
+
+            int _fd;
+            void *_addr = nullptr;
+            size_t _size = 0;
+
+        private:
+            [[noreturn]]
+            void Fail(const char *message)
+            {
+                const int err = errno;
+                ::close(_fd);
+                utils::Throw<std::runtime_error>(std::format("{}: {}", message, std::strerror(err)));
+            }
+        };
+
+        /// Pause instruction for spin loops
+        inline void SpinPause() noexcept
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    /// Ring buffer in shared memory
+    /// @tparam producers Single (SPSC) or multiple (MPSC) producers, possibly in different processes
+    template<RingProducers producers>
+    class SharedRing : private details::SharedMemory, public RingBuffer<producers>
+    {
+        using Base = RingBuffer<producers>;
+
+    public:
+        using typename Base::Record;
+        using typename Base::Reservation;
+
+        /// Number of spin iterations before a consumer sleeps in WaitMode::Adaptive
+        static constexpr uint32_t spinCount = 4096;
+
+        /// Creates a named shared memory object with a new ring
+        /// @param name Name of the object, starting with '/'
+        /// @param capacity Size of the data area, a power of two
+        /// @throw std::runtime_error if the object exists or cannot be created
+        [[nodiscard]] static
+        SharedRing Create(const std::string &name, size_t capacity)
+        {
+            const int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+            if(fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot create '{}': {}", name, std::strerror(errno)));
+            return SharedRing(fd, capacity, true);
+        }
+
+        /// Opens a ring created by another process
+        /// @throw std::runtime_error if the object cannot be opened
+        /// @throw std::invalid_argument if the object does not contain a ring
+        [[nodiscard]] static
+        SharedRing Open(const std::string &name)
+        {
+            const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+            if(fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot open '{}': {}", name, std::strerror(errno)));
+            return SharedRing(fd, 0, false);
+        }
+
+        /// Removes the name of a shared memory object; mapped rings remain valid
+        static
+        bool Unlink(const std::string &name) noexcept { return ::shm_unlink(name.c_str()) == 0; }
+
+        /// Creates a ring in an anonymous memfd; the descriptor (see Fd()) can be passed to another process
+        /// @throw std::runtime_error if the memfd cannot be created
+        [[nodiscard]] static
+        SharedRing CreateAnonymous(size_t capacity)
+        {
+            const int fd = ::memfd_create("serdes-ring", MFD_CLOEXEC);
+            if(fd < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot create memfd: {}", std::strerror(errno)));
+            return SharedRing(fd, capacity, true);
+        }
+
+        /// Maps a ring from a descriptor received from another process
+        /// @param fd Descriptor of the shared memory; the ring uses a duplicate of it
+        [[nodiscard]] static
+        SharedRing Attach(int fd)
+        {
+            const int dup = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+            if(dup < 0)
+                utils::Throw<std::runtime_error>(std::format("cannot duplicate descriptor: {}", std::strerror(errno)));
+            return SharedRing(dup, 0, false);
+        }
+
+        /// Descriptor of the shared memory
+        [[nodiscard]]
+        int Fd() const noexcept { return _fd; }
+
+        //----------------------------------------------------------------------
+        // Producer side
+
+        /// Publishes a reserved record and wakes a sleeping consumer
+        void Commit(const Reservation &reservation, uint32_t size)
+        {
+            Base::Commit(reservation, size);
+            Notify();
+        }
+
+        void Commit(const Reservation &reservation)
+        {
+            Base::Commit(reservation);
+            Notify();
+        }
+
+        /// Serializes values directly into the ring and wakes a sleeping consumer
+        /// @return false if the ring does not have enough free space
+        template<CSerdes ...TSerdes, typename ...TValues>
+        bool Write(const TValues &...values)
+        {
+            if(!Base::template Write<TSerdes...>(values...))
+                return false;
+            Notify();
+            return true;
+        }
+
+        //----------------------------------------------------------------------
+        // Consumer side
+
+        using Base::Read;
+
+        /// Waits for the next committed record
+        /// @return Empty record if the timeout expired
+        [[nodiscard]]
+        Record Wait(std::chrono::nanoseconds timeout, WaitMode mode = WaitMode::Adaptive)
+        {
+            using Clock = std::chrono::steady_clock;
+            const auto deadline = Clock::now() + timeout;
+
+            // Spinning
+            for(uint32_t i = 1; mode == WaitMode::BusyPoll || i <= spinCount; i++)
+            {
+                if(Record record = this->Peek())
+                    return record;
+                details::SpinPause();
+
+                if(i % 1024 == 0 && Clock::now() >= deadline)
+                    return {};
+            }
+
+            // Sleeping; a producer wakes the consumer if it sees the waiter
+            RingControl &control = this->Control();
+            while(true)
+            {
+                control.waiters.fetch_add(1);
+                const uint32_t sequence = control.sequence.load();
+
+                Record record = this->Peek();
+                const auto now = Clock::now();
+                if(!record && now < deadline)
+                    FutexWait(control.sequence, sequence, deadline - now);
+
+                control.waiters.fetch_sub(1);
+
+                if(record)
+                    return record;
+                if(Clock::now() >= deadline)
+                    return this->Peek();
+            }
+        }
+
+        /// Waits for the next record, deserializes and removes it
+        /// @return false if the timeout expired
+        template<CSerdes ...TSerdes, typename ...TValues>
+        bool Read(std::chrono::nanoseconds timeout, TValues &...values)
+        {
+            const Record record = Wait(timeout);
+            if(!record)
+                return false;
+
+            SerdesT<TSerdes...>::DeserializeFrom(record.begin(), values...);
+            this->Release(record);
+            return true;
+        }
+
+    private:
+        SharedRing(int fd, size_t capacity, bool create)
+            : details::SharedMemory(fd, create ? Base::RequiredSize(capacity) : 0)
+            , Base(_addr, _size, create)
+        {}
+
+        /// Wakes sleeping consumers after a record has been committed
+        void Notify() noexcept
+        {
+            RingControl &control = this->Control();
+            control.sequence.fetch_add(1);
+            if(control.waiters.load())
+                ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&control.sequence), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        static
+        void FutexWait(std::atomic<uint32_t> &word, uint32_t expected, std::chrono::nanoseconds timeout) noexcept
+        {
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            const timespec ts{static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+        }
+    };
+
+} // namespace serdes
+
+//------------------------------------------------------------------------------
+#endif
@@ -18,6 +18,14 @@
 #include "Core/Concepts.hpp"
 #include "Core/Typedefs.hpp"
 #include "Core/Api.hpp"
+#include "Core/Skip.hpp"
+#include "Core/Filter.hpp"
+#include "Core/Decoder.hpp"
+#include "Core/Visit.hpp"
+#include "Core/Parallel.hpp"
+#include "Core/Batch.hpp"
+#include "Core/Fingerprint.hpp"
+#include "Core/Frame.hpp"
 
 //------------------------------------------------------------------------------
 namespace serdes
@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the asynchronous double-buffered writer (io_uring and pwrite backends)
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <csignal>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <Serdes/Io/AsyncFileWriter.hpp>
+#include <Serdes/Io/MappedFile.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    template<typename TFunction>
+    bool Throws(TFunction &&function)
+    {
+        try { function(); } catch(const std::runtime_error &) { return true; }
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    using Entry = Tuple<UInt64, String, Vector<Double>>;
+    TempFile file;
+
+    for(bool useIoUring: {true, false})
+    {
+        // Many flushes through small buffers, with synchronization tickets in between
+        std::vector<uint8_t> expected;
+        uint64_t lastSync = 0;
+        {
+            AsyncFileWriter writer(file.Path(), {.bufferSize = 4096, .useIoUring = useIoUring});
+            SERDES_CHECK(useIoUring || !writer.UsesIoUring());
+
+            for(uint64_t i = 0; i < 2000; i++)
+            {
+                const std::string text(i % 50, 'a');
+                const std::vector<double> values(i % 20, 0.5 * i);
+                SerializeTo<Entry>(writer.begin(), i, text, values);
+                SerializeTo<Entry>(std::back_inserter(expected), i, text, values);
+
+                if(i % 300 == 0)
+                {
+                    const uint64_t ticket = writer.Sync();
+                    SERDES_CHECK(ticket > lastSync);
+                    lastSync = ticket;
+                }
+            }
+
+            SERDES_CHECK(writer.Position() == expected.size());
+            writer.Wait(lastSync);
+            SERDES_CHECK(writer.IsComplete(lastSync) && writer.Completed() >= lastSync);
+            writer.Close();
+        }
+
+        MappedFile mapped(file.Path());
+        SERDES_CHECK(mapped.size() == expected.size() && std::equal(mapped.begin(), mapped.end(), expected.begin()));
+
+        // Writes start at the given offset of a descriptor owned by the caller
+        const int fd = ::open(file.Path().c_str(), O_WRONLY);
+        {
+            AsyncFileWriter writer(fd, {.offset = 8, .useIoUring = useIoUring});
+            SerializeTo<UInt64>(writer.begin(), 0x0102030405060708ull);
+            writer.Wait(writer.Sync());
+        }
+        SERDES_CHECK(::fcntl(fd, F_GETFD) >= 0);
+        ::close(fd);
+
+        MappedFile patched(file.Path());
+        uint64_t value = 0;
+        DeserializeFrom<UInt64>(patched.data() + 8, value);
+        SERDES_CHECK(value == 0x0102030405060708ull);
+
+        // A failed write is reported by every following wait, including waits for later tickets
+        const int readOnly = ::open(file.Path().c_str(), O_RDONLY);
+        {
+            AsyncFileWriter writer(readOnly, {.bufferSize = 4096, .useIoUring = useIoUring});
+            writer.Write(expected.data(), 100);
+
+            SERDES_CHECK(Throws([&] { writer.Wait(writer.Flush()); }));
+            SERDES_CHECK(Throws([&] { writer.Wait(1); }));
+            SERDES_CHECK(Throws([&] { (void)writer.Completed(); }));
+            SERDES_CHECK(Throws([&] { writer.Wait(writer.Sync()); }));
+            SERDES_CHECK(Throws([&] { writer.Close(); }));
+        }
+        ::close(readOnly);
+
+        // A write cut short by the file size limit is continued; the failure of the rest
+        // is reported by the synchronization ticket
+        rlimit limit{};
+        ::getrlimit(RLIMIT_FSIZE, &limit);
+        const rlim_t soft = limit.rlim_cur;
+        std::signal(SIGXFSZ, SIG_IGN);
+        limit.rlim_cur = 10000;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        {
+            AsyncFileWriter writer(file.Path(), {.bufferSize = 1 << 16, .useIoUring = useIoUring});
+            writer.Write(expected.data(), 20000);
+            const uint64_t sync = writer.Sync();
+            SERDES_CHECK(Throws([&] { writer.Wait(sync); }));
+            SERDES_CHECK(Throws([&] { writer.Wait(sync); }));
+        }
+        limit.rlim_cur = soft;
+        ::setrlimit(RLIMIT_FSIZE, &limit);
+        SERDES_CHECK(MappedFile(file.Path()).size() == 10000);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of batches of length-prefixed messages
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// Batches can be serialized from the range
+    template<typename TSerdes, typename TRange>
+    concept CBatchable = requires(const TRange &values) { serdes::SerializeBatch<TSerdes>(values); };
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    using Message = Tuple<Int32, String>;
+    std::vector<ValueT<Message>> messages;
+    for(int32_t i = 0; i < 100; i++)
+        messages.emplace_back(i, std::string(i % 5, 'x'));
+
+    // Each record is the message length followed by the message
+    const auto batch = SerializeBatch<Message>(messages);
+    SERDES_CHECK(batch.size() == SizeofBatch<Message>(messages));
+
+    std::vector<ValueT<Message>> decoded;
+    DeserializeBatch<Message>(batch.cbegin(), batch.cend(), std::back_inserter(decoded));
+    SERDES_CHECK(decoded == messages);
+
+    // A callback returning false stops at the next record
+    size_t visited = 0;
+    auto next = DeserializeBatch<Message>(batch.cbegin(), batch.cend(), [&](const ValueT<Message> &message)
+    {
+        visited++;
+        return std::get<0>(message) < 9;
+    });
+    SERDES_CHECK(visited == 10 && next != batch.cend());
+    decoded.clear();
+    DeserializeBatch<Message>(next, batch.cend(), std::back_inserter(decoded));
+    SERDES_CHECK(decoded.size() == 90 && std::get<0>(decoded.front()) == 10);
+
+    // Appending to a byte container and writing to an external buffer
+    std::vector<uint8_t> sink{1, 2};
+    SERDES_CHECK(SerializeBatch<Message>(messages, sink) == batch.size());
+    SERDES_CHECK(sink.size() == batch.size() + 2 && std::equal(batch.begin(), batch.end(), sink.begin() + 2));
+
+    const std::vector<int64_t> numbers{1, 2, 3};
+    const auto staticBatch = SerializeBatch<Int64>(numbers);
+    SERDES_CHECK(staticBatch.size() == 3 * (4 + 8));
+
+    std::vector<uint8_t> external(staticBatch.size());
+    SERDES_CHECK(SerializeBatchTo<Int64>(external.begin(), numbers) == external.end() && external == staticBatch);
+
+    // Views are traversed twice; single-pass ranges and views not iterable when const are rejected
+    auto doubled = numbers | std::views::transform([](int64_t x) { return 2 * x; });
+    const auto doubledBatch = SerializeBatch<Int64>(doubled);
+    std::vector<int64_t> values;
+    DeserializeBatch<Int64>(doubledBatch.begin(), doubledBatch.end(), [&](int64_t x) { values.push_back(x); });
+    SERDES_CHECK((values == std::vector<int64_t>{2, 4, 6}));
+
+    auto even = numbers | std::views::filter([](int64_t x) { return x % 2 == 0; });
+    static_assert(CBatchable<Int64, decltype(doubled)>);
+    static_assert(!CBatchable<Int64, decltype(even)>);
+    static_assert(!CBatchable<Int64, std::ranges::istream_view<int64_t>>);
+
+    // A truncated record and a record whose length does not match the message are reported
+    auto truncated = staticBatch;
+    truncated.pop_back();
+    bool thrown = false;
+    try { DeserializeBatch<Int64>(truncated.begin(), truncated.end(), [](int64_t) {}); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    auto mismatched = batch;
+    SerializeTo<UInt32>(mismatched.data(), 5u);
+    thrown = false;
+    try { DeserializeBatch<Message>(mismatched.begin(), mismatched.end(), [](const ValueT<Message> &) {}); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of bit fields packed inside tuples
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <stdexcept>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+enum class Side : uint8_t { Buy, Sell };
+
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Consecutive bit fields share bytes
+    using Status = Tuple<Bits<3>, Flag, BitField<Side, 2>, Bits<12>>;
+    static_assert(Status::Sizeof() == 3);
+    CheckRoundTrip<Status>({5, true, Side::Sell, 4095});
+    CheckRoundTrip<Status>({0, false, Side::Buy, 0});
+
+    // Signed fields are sign-extended
+    CheckRoundTrip<Tuple<BitField<int8_t, 4>, BitField<int16_t, 12>>>({-8, -2048});
+
+    // Groups of bit fields separated by other fields, dynamic tuples
+    using Record = Tuple<Flag, String, Bits<7>, Bits<9>, Vector<Int32>, Flag>;
+    CheckRoundTrip<Record>({true, "abc", 100, 300, {1, -2}, false});
+
+    // The incremental decoder scans the groups and the other fields of dynamic tuples in order
+    static_assert(details::CScannable<Record>);
+    CheckDecoder<Record>({true, "abc", 100, 300, {1, -2}, false});
+    CheckDecoder<Tuple<Bits<40>, Bits<40>, String>>({1ull << 39, 5, "groups of 5 bytes"});
+    CheckDecoder<Status>({5, true, Side::Sell, 4095});
+
+    // The number of bits is a part of the layout
+    static_assert(Fingerprint<Bits<9>> != Fingerprint<Bits<16>>);
+
+    // Values exceeding the field are rejected
+    bool thrown = false;
+    try { (void)Serialize<Status>(std::tuple<uint8_t, bool, Side, uint16_t>{8, false, Side::Buy, 0}); }
+    catch(const std::out_of_range &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
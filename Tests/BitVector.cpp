@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the bit-packed boolean sequences
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <array>
+#include <algorithm>
+#include <bitset>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<bool> flags;
+    for(int i = 0; i < 1003; i++)
+        flags.push_back(i % 3 == 0 || i % 7 == 0);
+    CheckRoundTrip<BitVector<>>(flags);
+    SERDES_CHECK(BitVector<>::Sizeof(flags) == 4 + (flags.size() + 7) / 8);
+
+    CheckRoundTrip<BitVector<>>({});
+    CheckRoundTrip<BitVector<>>({true});
+
+    // Contiguous flags are packed with the same bit order
+    std::vector<bool> pattern(64);
+    std::array<bool, 64> contiguous{};
+    for(size_t i = 0; i < 64; i++)
+        pattern[i] = contiguous[i] = i % 5 == 1;
+    SERDES_CHECK(Serialize<BitRange<UInt32, std::array<bool, 64>>>(contiguous) == Serialize<BitVector<>>(pattern));
+
+    // Any nonzero byte is a set flag
+    std::vector<uint8_t> bytes(70);
+    for(size_t i = 0; i < bytes.size(); i++)
+        bytes[i] = i % 5 == 1 ? static_cast<uint8_t>(0x80 | i) : 0;
+    bytes[3] = 0xFF;
+    std::vector<bool> expected(bytes.size());
+    for(size_t i = 0; i < bytes.size(); i++)
+        expected[i] = bytes[i] != 0;
+    SERDES_CHECK(Serialize<BitRange<UInt32, std::vector<uint8_t>>>(bytes) == Serialize<BitVector<>>(expected));
+
+    std::vector<uint8_t> unpacked;
+    DeserializeFrom<BitRange<UInt32, std::vector<uint8_t>>>(Serialize<BitVector<>>(expected).data(), unpacked);
+    SERDES_CHECK(std::ranges::equal(unpacked, expected, {}, [](uint8_t byte) { return byte != 0; })
+                 && std::ranges::all_of(unpacked, [](uint8_t byte) { return byte <= 1; }));
+
+    std::bitset<77> bits;
+    for(size_t i = 0; i < bits.size(); i += 3)
+        bits.set(i);
+    CheckRoundTrip<BitArray<77>>(bits);
+    SERDES_CHECK(BitArray<77>::Sizeof() == 10);
+
+    // Arrays of the same byte size have different layouts
+    SERDES_CHECK(Fingerprint<BitArray<9>> != Fingerprint<BitArray<16>>);
+
+    // The incremental decoder waits for all packed bytes
+    CheckDecoder<BitVector<>>(flags);
+    CheckDecoder<BitVector<>>({});
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of sequences divided into chunks of known byte length
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <ranges>
+#include <string>
+#include <Serdes/Io/GatherWriter.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<std::string> strings(5000);
+    for(size_t i = 0; i < strings.size(); i++)
+        strings[i] = std::string(i % 37, static_cast<char>('a' + i % 26));
+
+    // The chunk lengths precede the elements, which are laid out as in a Sequence
+    using Strings = ChunkedVector<String>;
+    const auto buffer = Serialize<Strings>(strings);
+    SERDES_CHECK(buffer.size() == 4 + 4 * 5 + Sizeof<Vector<String>>(strings) - 4);
+    CheckRoundTrip<Strings>(strings);
+    CheckRoundTrip<Strings>({});
+
+    std::vector<uint8_t> appended;
+    SerializeTo<Strings>(std::back_inserter(appended), strings);
+    SERDES_CHECK(appended == buffer);
+
+    // Elements with a static buffer and a short last chunk
+    using Ints = Chunked<UInt32, Int32, std::vector<int32_t>, 3>;
+    const std::vector<int32_t> ints{1, 2, 3, 4, 5, 6, 7};
+    SERDES_CHECK(Serialize<Ints>(ints).size() == 4 + 3 * 4 + 7 * 4);
+    CheckRoundTrip<Ints>(ints);
+
+    // Elements produced on the fly are copied by a GatherWriter instead of being referenced
+    auto generated = std::views::iota(0, 50) | std::views::transform([](int i) { return std::string(100 + i, static_cast<char>('a' + i % 26)); });
+    using Generated = Chunked<UInt32, String, std::vector<std::string>, 8>;
+
+    GatherWriter writer(16);
+    SerializeTo<Generated>(writer.begin(), generated);
+    std::vector<uint8_t> gathered;
+    for(const iovec &segment: writer.Iovecs())
+        gathered.insert(gathered.end(), static_cast<const uint8_t *>(segment.iov_base), static_cast<const uint8_t *>(segment.iov_base) + segment.iov_len);
+    SERDES_CHECK(gathered == Serialize<Generated>(std::vector<std::string>(generated.begin(), generated.end())));
+
+    // The incremental decoder locates the end of the value from the chunk lengths
+    CheckDecoder<Strings>(std::vector<std::string>(strings.begin(), strings.begin() + 2100));
+    CheckDecoder<Ints>(ints);
+    CheckDecoder<Ints>({});
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#ifndef SERDES_TESTS_COMMON_HPP
+#define SERDES_TESTS_COMMON_HPP
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Helpers of the tests
+
+    @details
+        Checks are performed regardless of NDEBUG; a failed check prints the
+        condition and terminates the test with a nonzero exit code.
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <utility>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+#include <Serdes/Serdes.hpp>
+
+//------------------------------------------------------------------------------
+#define SERDES_CHECK(...) ::serdes::test::Check((__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+namespace serdes::test
+{
+    inline
+    void Check(bool condition, const char *text, const char *file, int line)
+    {
+        if(!condition)
+        {
+            std::cerr << file << ':' << line << ": check failed: " << text << '\n';
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    /// Temporary file removed by the destructor
+    class TempFile
+    {
+    public:
+        TempFile()
+        {
+            std::string path = "/tmp/serdes_test_XXXXXX";
+            const int fd = ::mkstemp(path.data());
+            Check(fd >= 0, "mkstemp", __FILE__, __LINE__);
+            ::close(fd);
+            _path = std::move(path);
+        }
+
+        TempFile(const TempFile &) = delete;
+        TempFile &operator=(const TempFile &) = delete;
+
+        ~TempFile() { ::unlink(_path.c_str()); }
+
+        [[nodiscard]]
+        const std::string &Path() const noexcept { return _path; }
+
+    private:
+        std::string _path;
+    };
+
+    /// Serializes the value, checks the size, deserializes it back and skips it
+    template<CSerdes TSerdes>
+    void CheckRoundTrip(const ValueT<TSerdes> &value)
+    {
+        const auto buffer = Serialize<TSerdes>(value);
+        SERDES_CHECK(buffer.size() == TSerdes::Sizeof(value));
+
+        ValueT<TSerdes> result{};
+        const uint8_t *end = TSerdes::DeserializeFrom(buffer.data(), result);
+        SERDES_CHECK(end == buffer.data() + buffer.size());
+        SERDES_CHECK(result == value);
+
+        SERDES_CHECK(Skip<TSerdes>(buffer.data()) == buffer.data() + buffer.size());
+    }
+
+    /// Feeds the serialized value to IncrementalDecoder byte by byte and checks that
+    /// the decoder completes exactly at the end of the value
+    template<CSerdes TSerdes>
+    void CheckDecoder(const ValueT<TSerdes> &value)
+    {
+        const auto buffer = Serialize<TSerdes>(value);
+
+        IncrementalDecoder<TSerdes> decoder;
+        for(size_t i = 0; i < buffer.size(); i++)
+        {
+            SERDES_CHECK(!decoder.Status().IsDone() && decoder.Status().needed <= buffer.size() - i);
+            (void)decoder.Feed({buffer.data() + i, 1});
+        }
+
+        SERDES_CHECK(decoder.Status().IsDone() && decoder.Size() == buffer.size());
+        SERDES_CHECK(decoder.Value() == value);
+    }
+
+} // namespace serdes::test
+
+//------------------------------------------------------------------------------
+#endif
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the compressed serdes
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <list>
+#include <string>
+#include <stdexcept>
+#include <Serdes/Io/GatherWriter.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// String serdes counting serializations
+    struct CountedString : serdes::String
+    {
+        static inline size_t serialized = 0;
+
+        template<serdes::COutputIterator TOutputIterator>
+        static
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const std::string &value)
+        {
+            serialized++;
+            return serdes::String::SerializeTo(bufpos, value);
+        }
+    };
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Repetitive data spanning several blocks is compressed
+    std::vector<std::string> log;
+    for(int i = 0; i < 20000; i++)
+        log.push_back("order " + std::to_string(i % 100) + " filled");
+    CheckRoundTrip<Compressed<Vector<String>>>(log);
+    SERDES_CHECK(Compressed<Vector<String>>::Sizeof(log) < Vector<String>::Sizeof(log) / 4);
+
+    // Incompressible data is stored in raw blocks
+    std::vector<uint64_t> noise;
+    uint64_t state = 88172645463325252ull;
+    for(int i = 0; i < 10000; i++)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        noise.push_back(state);
+    }
+    CheckRoundTrip<Compressed<Vector<UInt64>, 4096>>(noise);
+
+    CheckRoundTrip<Compressed<Vector<UInt64>>>({});
+    CheckRoundTrip<Compressed<String>>("a");
+    CheckRoundTrip<Compressed<String>>(std::string(13, 'x'));
+    CheckRoundTrip<Compressed<String>>(std::string(100, 'x') + "abc" + std::string(100, 'x'));
+
+    // Two values in a tuple, each compressed separately
+    CheckRoundTrip<Tuple<Compressed<Vector<String>>, Compressed<Vector<UInt64>>>>({log, noise});
+
+    // The gather writer keeps the blocks after the cache is reused for the next value
+    using Pair = Tuple<Compressed<Vector<UInt64>>, Compressed<Vector<UInt64>>>;
+    std::vector<uint64_t> ids(5000, 7);
+    GatherWriter writer;
+    SerializeTo<Pair>(writer.begin(), noise, ids);
+
+    std::vector<uint8_t> gathered;
+    for(const iovec &segment: writer.Iovecs())
+    {
+        const auto *data = static_cast<const uint8_t *>(segment.iov_base);
+        gathered.insert(gathered.end(), data, data + segment.iov_len);
+    }
+    SERDES_CHECK(gathered == Serialize<Pair>(noise, ids));
+
+    // Streaming to an output iterator without block writes gives the same bytes
+    using Log = Compressed<Vector<String>, 1024>;
+    std::list<uint8_t> streamed;
+    SerializeTo<Log>(std::back_inserter(streamed), log);
+    const auto expected = Serialize<Log>(log);
+    SERDES_CHECK(streamed.size() == Log::Sizeof(log) && std::equal(streamed.begin(), streamed.end(), expected.begin()));
+
+    // Serialize() does not compress the values a second time to determine the size
+    std::vector<std::string> names(100, "name");
+    using Names = Vector<Compressed<CountedString>>;
+    const auto namesBuffer = Serialize<Names>(names);
+    SERDES_CHECK(CountedString::serialized == names.size());
+    SERDES_CHECK(namesBuffer.size() == Names::Sizeof(names));
+
+    ValueT<Names> namesResult;
+    DeserializeFrom<Names>(namesBuffer.cbegin(), namesResult);
+    SERDES_CHECK(namesResult == names);
+
+    // The block size is a part of the layout
+    static_assert(Fingerprint<Compressed<String, 4096>> != Fingerprint<Compressed<String, 8192>>);
+
+    // Corrupted blocks are reported: a compressed block marked as stored
+    auto corrupted = Serialize<Log>(log);
+    corrupted[2 * sizeof(uint32_t) - 1] ^= 0x80;
+    bool thrown = false;
+    try { ValueT<Log> result; DeserializeFrom<Log>(corrupted.cbegin(), result); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    // The incremental decoder skips the blocks without decompressing them
+    CheckDecoder<Log>(std::vector<std::string>(log.begin(), log.begin() + 500));
+    CheckDecoder<Compressed<Vector<UInt64>>>({});
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of fixed-point decimal numbers and their serdes
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <limits>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    using Price = FixedDecimal<2>;
+    using Qty = FixedDecimal<8>;
+
+    // Parsing and formatting are exact
+    SERDES_CHECK(Price::Parse("50200.05").mantissa == 5020005);
+    SERDES_CHECK(Price::Parse("-0.5").ToString() == "-0.50");
+    SERDES_CHECK(Price::Parse("7").ToString() == "7.00");
+    SERDES_CHECK(Qty::Parse("0.00012300").mantissa == 12300);
+    SERDES_CHECK(Price::Parse("1.2300") == Price::Parse("1.23"));
+
+    Price price;
+    SERDES_CHECK(!Price::TryParse("1.234", price));
+    SERDES_CHECK(!Price::TryParse("", price));
+    SERDES_CHECK(!Price::TryParse("1e5", price));
+    SERDES_CHECK(!Price::TryParse("92233720368547758.08", price));
+    SERDES_CHECK(Price::TryParse("-92233720368547758.08", price) && price.mantissa == std::numeric_limits<int64_t>::min());
+
+    // Serialization of the mantissa
+    CheckRoundTrip<Decimal<2>>(Price::Parse("50200.05"));
+    CheckRoundTrip<Decimal<8, VarInt64>>(Qty::Parse("-0.001"));
+    SERDES_CHECK(Decimal<8, VarInt64>::Sizeof(Qty::Parse("0.00000001")) == 1);
+    CheckRoundTrip<Vector<Decimal<2, VarInt64>>>({Price::Parse("1.01"), Price::Parse("-2"), Price{}});
+    CheckDecoder<Vector<Decimal<2, VarInt64>>>({Price::Parse("1.01"), Price::Parse("-2"), Price{}});
+
+    // The scale is a part of the layout
+    static_assert(Fingerprint<Decimal<2>> != Fingerprint<Decimal<8>>);
+    static_assert(Fingerprint<Decimal<2>> != Fingerprint<Int64>);
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the incremental decoder fed with fragments of values
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <random>
+#include <stdexcept>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    using namespace serdes;
+
+    /// Number of calls of the scan hook of VarintList
+    size_t scanCalls = 0;
+
+    /// Number of calls of the skip function of VarintList
+    size_t skipCalls = 0;
+
+    /// List of LEB128 integers preceded by their count
+    /// @tparam scannable The serdes provides a scan hook, otherwise only a skip function
+    template<bool scannable>
+    struct VarintList
+    {
+        using ValueType = std::vector<uint64_t>;
+
+        static consteval
+        TypeId GetTypeId() { return TypeId::Varint; }
+
+        static consteval
+        BufferType GetBufferType() { return BufferType::Dynamic; }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof() { return std::numeric_limits<uint32_t>::max(); }
+
+        [[nodiscard]] static constexpr
+        uint32_t Sizeof(const ValueType &value)
+        {
+            uint32_t size = details::VarintSize(value.size());
+            for(uint64_t element: value)
+                size += details::VarintSize(element);
+            return size;
+        }
+
+        template<COutputIterator TOutputIterator>
+        static constexpr
+        TOutputIterator SerializeTo(TOutputIterator bufpos, const ValueType &value)
+        {
+            bufpos = details::SerializeVarint(bufpos, value.size());
+            for(uint64_t element: value)
+                bufpos = details::SerializeVarint(bufpos, element);
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator DeserializeFrom(TInputIterator bufpos, ValueType &value)
+        {
+            uint64_t size = 0;
+            bufpos = details::DeserializeVarint(bufpos, size);
+            value.resize(size);
+            for(uint64_t &element: value)
+                bufpos = details::DeserializeVarint(bufpos, element);
+            return bufpos;
+        }
+
+        template<CInputIterator TInputIterator>
+        static constexpr
+        TInputIterator Skip(TInputIterator bufpos)
+        {
+            skipCalls++;
+            uint64_t size = 0;
+            for(bufpos = details::DeserializeVarint(bufpos, size); size; size--)
+                bufpos = details::SkipVarint(bufpos);
+            return bufpos;
+        }
+
+        template<typename TCursor>
+        requires scannable
+        static constexpr
+        bool Scan(TCursor &cursor)
+        {
+            scanCalls++;
+            uint64_t size = 0;
+            if(!cursor.ReadVarint(size))
+                return false;
+
+            cursor.Finish();
+            cursor.Varints(size);
+            return true;
+        }
+    };
+
+    /// Feeds the serialized values in fragments of random sizes (1 to maxFragment bytes)
+    /// and checks the decoded values
+    template<CSerdes TSerdes>
+    void CheckFragments(const std::vector<ValueT<TSerdes>> &values, size_t maxFragment, std::mt19937 &random)
+    {
+        std::vector<uint8_t> buffer;
+        for(const auto &value: values)
+            SerializeTo<TSerdes>(std::back_inserter(buffer), value);
+
+        IncrementalDecoder<TSerdes> decoder;
+        std::uniform_int_distribution<size_t> fragment(1, maxFragment);
+        size_t decoded = 0;
+
+        for(size_t pos = 0; pos < buffer.size();)
+        {
+            const size_t n = std::min(fragment(random), buffer.size() - pos);
+            auto status = decoder.Feed({buffer.data() + pos, n});
+            pos += n;
+
+            for(; status.IsDone(); status = decoder.Next())
+            {
+                SERDES_CHECK(decoder.Size() == TSerdes::Sizeof(values[decoded]));
+                SERDES_CHECK(decoder.Value() == values[decoded]);
+                decoded++;
+            }
+
+            // The missing bytes of an incomplete value are never overestimated
+            SERDES_CHECK(status.needed > 0 && (pos == buffer.size() || status.needed <= buffer.size() - pos));
+        }
+
+        SERDES_CHECK(decoded == values.size());
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::mt19937 random(1);
+
+    // Composite values: ranges, nested tuples and variants
+    using Message = Tuple<UInt32, String, Vector<Tuple<UInt8, String>>, Variant<Int32, String, Vector<Double>>>;
+
+    std::vector<ValueT<Message>> messages;
+    for(int i = 0; i < 50; i++)
+    {
+        std::vector<std::tuple<uint8_t, std::string>> items;
+        for(int j = 0; j < i % 7; j++)
+            items.emplace_back(static_cast<uint8_t>(j), std::string(j * 3, 'x'));
+
+        std::variant<int32_t, std::string, std::vector<double>> alternative;
+        if(i % 3 == 1)
+            alternative = std::string(i, 'y');
+        else if(i % 3 == 2)
+            alternative = std::vector<double>(i, 0.25);
+        else
+            alternative = i;
+
+        messages.emplace_back(i, std::string(i * 5, 'm'), std::move(items), std::move(alternative));
+    }
+
+    for(size_t maxFragment: {1, 3, 64, 4096})
+        CheckFragments<Message>(messages, maxFragment, random);
+
+    // Pointers: the null flag followed by the pointee
+    for(int64_t *pointee: {static_cast<int64_t *>(nullptr), new int64_t(-5)})
+    {
+        using Pointer = Tuple<Ptr<Int64>, UInt8>;
+        const auto buffer = Serialize<Pointer>(pointee, 9);
+
+        IncrementalDecoder<Pointer> decoder;
+        for(uint8_t byte: buffer)
+            (void)decoder.Feed({&byte, 1});
+        SERDES_CHECK(decoder.Status().IsDone() && decoder.Size() == buffer.size());
+
+        int64_t *result = nullptr;
+        uint8_t tail = 0;
+        decoder.DeserializeTo(result, tail);
+        SERDES_CHECK(tail == 9 && (pointee ? result && *result == -5 : !result));
+        delete result;
+        delete pointee;
+    }
+
+    // Serdes with a scan hook and with a skip function only, alone and inside a tuple
+    std::vector<std::vector<uint64_t>> lists;
+    for(uint64_t i = 0; i < 20; i++)
+    {
+        std::vector<uint64_t> list;
+        for(uint64_t j = 0; j < i * 100; j++)
+            list.push_back(j << (j % 60));
+        lists.push_back(std::move(list));
+    }
+
+    for(size_t maxFragment: {1, 5, 1000})
+    {
+        CheckFragments<VarintList<true>>(lists, maxFragment, random);
+        CheckFragments<VarintList<false>>(lists, maxFragment, random);
+    }
+
+    using Pair = Tuple<VarintList<true>, String>;
+    std::vector<ValueT<Pair>> pairs;
+    for(const auto &list: lists)
+        pairs.emplace_back(list, "after");
+    CheckFragments<Pair>(pairs, 2, random);
+
+    // A value fed byte by byte is scanned once: the hook is called on construction and
+    // again only while the count is incomplete; the skip function runs on every fragment
+    const std::vector<uint64_t> list(5000, 300);
+    const auto buffer = Serialize<VarintList<true>>(list);
+
+    scanCalls = 0;
+    IncrementalDecoder<VarintList<true>> scanned;
+    for(uint8_t byte: buffer)
+        (void)scanned.Feed({&byte, 1});
+    SERDES_CHECK(scanned.Status().IsDone() && scanned.Value() == list);
+    SERDES_CHECK(scanCalls == 1 + details::VarintSize(list.size()));
+
+    skipCalls = 0;
+    IncrementalDecoder<VarintList<false>> probed;
+    for(size_t pos = 0; pos < buffer.size(); pos += 1000)
+        (void)probed.Feed({buffer.data() + pos, std::min<size_t>(1000, buffer.size() - pos)});
+    SERDES_CHECK(probed.Status().IsDone() && probed.Value() == list);
+    SERDES_CHECK(skipCalls == 1 + (buffer.size() + 999) / 1000);
+
+    // Committing more than the prepared space is rejected
+    IncrementalDecoder<String> decoder;
+    const auto space = decoder.Prepare(16);
+    bool thrown = false;
+    try { (void)decoder.Commit(space.size() + 1); } catch(const std::length_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the delta and delta-of-delta serdes
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <limits>
+#include <chrono>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<uint64_t> ids;
+    std::vector<int64_t> timestamps;
+    for(int64_t i = 0; i < 10000; i++)
+    {
+        ids.push_back(1000000 + 3 * static_cast<uint64_t>(i) + static_cast<uint64_t>(i % 7 == 0));
+        timestamps.push_back(1700000000000 + 1000 * i + (i % 13) - 6);
+    }
+
+    CheckRoundTrip<DeltaVector<UInt64>>(ids);
+    CheckRoundTrip<DeltaOfDelta<Int64>>(timestamps);
+    CheckRoundTrip<DeltaVector<Int64>>(timestamps);
+    CheckRoundTrip<DeltaOfDelta<UInt64>>(ids);
+
+    // Small differences are compressed
+    SERDES_CHECK(DeltaVector<UInt64>::Sizeof(ids) < ids.size() * 2 + 16);
+    SERDES_CHECK(DeltaOfDelta<Int64>::Sizeof(timestamps) < timestamps.size() * 2 + 16);
+
+    // Empty and single-element sequences, wrap-around differences
+    CheckRoundTrip<DeltaVector<Int64>>({});
+    CheckRoundTrip<DeltaOfDelta<Int64>>({42});
+    CheckRoundTrip<DeltaVector<Int64>>({std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), 0, -1});
+    CheckRoundTrip<DeltaOfDelta<UInt32>>({0, std::numeric_limits<uint32_t>::max(), 0, 5});
+
+    // Durations
+    using Ticks = Pod<std::chrono::nanoseconds, PodTypeId::Int64>;
+    CheckRoundTrip<DeltaOfDelta<Ticks>>({std::chrono::nanoseconds(5), std::chrono::nanoseconds(10), std::chrono::nanoseconds(16)});
+
+    // The order of the differences is a part of the layout
+    static_assert(Fingerprint<DeltaVector<Int64>> != Fingerprint<DeltaOfDelta<Int64>>);
+
+    // The incremental decoder resumes inside the differences
+    CheckDecoder<DeltaOfDelta<Int64>>(std::vector<int64_t>(timestamps.begin(), timestamps.begin() + 500));
+    CheckDecoder<DeltaVector<UInt64>>({});
+    CheckDecoder<DeltaVector<UInt64>>({7});
+    CheckDecoder<Vector<DeltaVector<Int64>>>({{1, 2, 3}, {}, {std::numeric_limits<int64_t>::min(), 0}});
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the dictionary encoding
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <string_view>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// Element type without a std::hash specialization
+    struct Point
+    {
+        int x, y;
+        bool operator==(const Point &) const = default;
+    };
+
+    template<typename TSerdes, typename TRange>
+    concept CSizeable = requires(const TRange &range) { TSerdes::Sizeof(range); };
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Low-cardinality values are stored once
+    const std::vector<std::string> symbols{"BTCUSDT", "ETHUSDT", "SOLUSDT"};
+    std::vector<std::string> column;
+    for(int i = 0; i < 5000; i++)
+        column.push_back(symbols[static_cast<size_t>(i * i) % symbols.size()]);
+    CheckRoundTrip<DictVector<String>>(column);
+    SERDES_CHECK(DictVector<String>::Sizeof(column) < column.size() + 64);
+
+    // Dictionaries larger than one and two bytes of codes
+    std::vector<uint32_t> wide;
+    for(uint32_t i = 0; i < 70000; i++)
+        wide.push_back(i % 300);
+    CheckRoundTrip<DictVector<UInt32>>(wide);
+    for(uint32_t i = 0; i < 70000; i++)
+        wide[i] = i;
+    CheckRoundTrip<DictVector<UInt32>>(wide);
+
+    CheckRoundTrip<DictVector<String>>({});
+
+    // String views refer to the dictionary values in the buffer
+    const auto buffer = Serialize<DictVector<String>>(column);
+    std::vector<std::string_view> views;
+    DeserializeFrom<DictVector<String>>(buffer.data(), views);
+    SERDES_CHECK(std::equal(views.begin(), views.end(), column.begin(), column.end()));
+    for(std::string_view view: views)
+        SERDES_CHECK(view.data() >= reinterpret_cast<const char *>(buffer.data())
+                     && view.data() + view.size() <= reinterpret_cast<const char *>(buffer.data() + buffer.size()));
+    SERDES_CHECK(views[0].data() == views[symbols.size()].data());
+
+    // Strings own copies of the values
+    ValueT<DictVector<String>> strings;
+    DeserializeFrom<DictVector<String>>(buffer.data(), strings);
+    SERDES_CHECK(strings == column && strings[0].data() != strings[symbols.size()].data());
+
+    // Elements must be hashable
+    static_assert(!CSizeable<DictVector<Pod<Point>>, std::vector<Point>>);
+    static_assert(CSizeable<DictVector<String>, std::vector<std::string>>);
+
+    // The incremental decoder handles all code widths
+    CheckDecoder<DictVector<String>>(std::vector<std::string>(column.begin(), column.begin() + 100));
+    CheckDecoder<DictVector<UInt32>>(std::vector<uint32_t>(wide.begin(), wide.begin() + 300));
+    CheckDecoder<DictVector<UInt32>>(wide);
+    CheckDecoder<DictVector<String>>({});
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the buffered file writer
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <csignal>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <Serdes/Io/FileWriter.hpp>
+#include <Serdes/Io/MappedFile.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// O_DIRECT is not supported by some file systems (e.g. tmpfs)
+    bool DirectSupported(const std::string &path)
+    {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_DIRECT);
+        if(fd < 0)
+            return false;
+        ::close(fd);
+        return true;
+    }
+
+    bool FileEquals(const std::string &path, size_t offset, const std::vector<uint8_t> &expected)
+    {
+        serdes::MappedFile file(path);
+        return file.size() == offset + expected.size() && std::equal(file.begin() + offset, file.end(), expected.begin());
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    using Message = Tuple<Vector<UInt64>, Vector<String>, Int32>;
+    std::vector<uint64_t> ids(300000);
+    for(size_t i = 0; i < ids.size(); i++)
+        ids[i] = i * 7;
+    const std::vector<std::string> names(10000, "hello");
+    const auto expected = Serialize<Message>(ids, names, -5);
+
+    TempFile file;
+    const bool direct = DirectSupported(file.Path());
+
+    // Small and large staging buffers, page cache and O_DIRECT output, periodic synchronization
+    for(bool useDirect: {false, true})
+        for(size_t bufferSize: {size_t(4096), size_t(1) << 20})
+        {
+            if(useDirect && !direct)
+                continue;
+
+            FileWriter writer(file.Path(), {.bufferSize = bufferSize, .direct = useDirect, .syncBytes = 1 << 20});
+            SerializeTo<Message>(writer.begin(), ids, names, -5);
+            SERDES_CHECK(writer.Position() == expected.size());
+            writer.Close();
+            SERDES_CHECK(writer.GetFd() < 0);
+            SERDES_CHECK(FileEquals(file.Path(), 0, expected));
+        }
+
+    // Positional writes to a descriptor owned by the caller, which stays open
+    int fd = ::open(file.Path().c_str(), O_RDWR | O_TRUNC);
+    {
+        FileWriter writer(fd, {.offset = 10});
+        SerializeTo<Message>(writer.begin(), ids, names, -5);
+        writer.Sync();
+    }
+    SERDES_CHECK(::fcntl(fd, F_GETFD) >= 0);
+    ::close(fd);
+    SERDES_CHECK(FileEquals(file.Path(), 10, expected));
+
+    // Blocks are assembled in reserved buffer space; a block larger than the buffer is refused
+    {
+        FileWriter writer(file.Path(), {.bufferSize = 4096});
+        for(size_t offset = 0; offset < expected.size(); offset += 1000)
+        {
+            const size_t size = std::min<size_t>(1000, expected.size() - offset);
+            uint8_t *space = writer.Reserve(size);
+            SERDES_CHECK(space != nullptr);
+            std::memcpy(space, expected.data() + offset, size);
+            writer.Commit(size);
+        }
+        SERDES_CHECK(writer.Reserve(4097) == nullptr && writer.Position() == expected.size());
+    }
+    SERDES_CHECK(FileEquals(file.Path(), 0, expected));
+
+    if(direct)
+    {
+        // The unaligned tail is written without O_DIRECT, which is restored on the caller's descriptor
+        fd = ::open(file.Path().c_str(), O_WRONLY | O_TRUNC | O_DIRECT);
+        {
+            FileWriter writer(fd, {.direct = true});
+            SerializeTo<Message>(writer.begin(), ids, names, -5);
+            writer.Close();
+        }
+        SERDES_CHECK((::fcntl(fd, F_GETFL) & O_DIRECT) != 0);
+        ::close(fd);
+        SERDES_CHECK(FileEquals(file.Path(), 0, expected));
+
+        // O_DIRECT output must start at an aligned offset
+        fd = ::open(file.Path().c_str(), O_WRONLY | O_DIRECT);
+        bool thrown = false;
+        try { FileWriter writer(fd, {.direct = true, .offset = 100}); } catch(const std::invalid_argument &) { thrown = true; }
+        SERDES_CHECK(thrown);
+        ::close(fd);
+    }
+
+    // A failed write is reported by Close, which still releases the descriptor
+    std::signal(SIGPIPE, SIG_IGN);
+    int pipefd[2];
+    SERDES_CHECK(::pipe(pipefd) == 0);
+    ::close(pipefd[0]);
+    {
+        FileWriter writer(pipefd[1]);
+        writer.Put(1);
+        bool thrown = false;
+        try { writer.Close(); } catch(const std::runtime_error &) { thrown = true; }
+        SERDES_CHECK(thrown && writer.GetFd() < 0);
+    }
+    ::close(pipefd[1]);
+
+    // Opening a file in a missing directory fails
+    bool thrown = false;
+    try { FileWriter writer(file.Path() + ".missing/file"); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of Skip and filtered deserialization of record sequences
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <map>
+#include <list>
+#include <string>
+#include <memory>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// Checks that Skip stops exactly at the end of the serialized value
+    template<serdes::CSerdes TSerdes>
+    void CheckSkip(const serdes::ValueT<TSerdes> &value)
+    {
+        const auto buffer = serdes::Serialize<TSerdes>(value);
+        SERDES_CHECK(serdes::Skip<TSerdes>(buffer.data()) == buffer.data() + buffer.size());
+        SERDES_CHECK(serdes::Skip<TSerdes>(buffer.begin()) == buffer.end());
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Skip reads only the structural fields of composite values
+    CheckSkip<UInt64>(42);
+    CheckSkip<String>("quote");
+    CheckSkip<Vector<String>>({"a", "", "abc"});
+    CheckSkip<Variant<Int32, String>>(std::string("text"));
+    CheckSkip<Tuple<UInt8, Vector<Double>, String>>({1, {1.5, 2.5}, "x"});
+    CheckSkip<Map<String, Vector<Int32>>>({{"a", {1, 2}}, {"b", {}}});
+
+    int32_t pointee = 7;
+    CheckSkip<Ptr<Int32>>(&pointee);
+    CheckSkip<Ptr<Int32>>(nullptr);
+
+    using Record = Tuple<UInt64, String, Double, Vector<Int32>, Variant<Int32, String>>;
+    using Records = Vector<Record>;
+
+    std::vector<ValueT<Record>> records;
+    for(int i = 0; i < 100; i++)
+        records.emplace_back(i, i % 3 ? "AAPL" : "MSFT", i * 1.5, std::vector<int32_t>(i % 5, i),
+                             i % 2 ? std::variant<int32_t, std::string>(i) : std::string("x"));
+    const auto buffer = Serialize<Records>(records);
+    CheckSkip<Records>(records);
+
+    // A single key: accepted records are decoded completely, the others are skipped
+    std::vector<ValueT<Record>> selected;
+    auto end = DeserializeIf<Records, 1>(buffer.data(), selected, [](const std::string &symbol) { return symbol == "MSFT"; });
+    SERDES_CHECK(end == buffer.data() + buffer.size());
+
+    std::vector<ValueT<Record>> expected;
+    for(const auto &record: records)
+        if(std::get<1>(record) == "MSFT")
+            expected.push_back(record);
+    SERDES_CHECK(!expected.empty() && selected == expected);
+
+    // Keys in any order; non-key fields before the last key are decoded for accepted records
+    std::list<ValueT<Record>> recent;
+    end = DeserializeIf<Records, 3, 0>(buffer.data(), recent,
+                                       [](const std::vector<int32_t> &values, uint64_t id) { return values.size() == 2 && id > 50; });
+    SERDES_CHECK(end == buffer.data() + buffer.size());
+
+    expected.clear();
+    for(const auto &record: records)
+        if(std::get<3>(record).size() == 2 && std::get<0>(record) > 50)
+            expected.push_back(record);
+    SERDES_CHECK(std::ranges::equal(recent, expected));
+
+    // Nothing accepted: the whole range is skipped
+    selected.clear();
+    end = DeserializeIf<Records, 0>(buffer.data(), selected, [](uint64_t) { return false; });
+    SERDES_CHECK(end == buffer.data() + buffer.size() && selected.empty());
+
+    // Every accepted record owns its pointee
+    using Owned = Vector<Tuple<UInt32, Ptr<Int32>>>;
+    int32_t values[] = {10, 20, 30, 40};
+    std::vector<ValueT<Tuple<UInt32, Ptr<Int32>>>> owned;
+    for(uint32_t i = 0; i < 4; i++)
+        owned.emplace_back(i, &values[i]);
+
+    const auto ownedBuffer = Serialize<Owned>(owned);
+    std::vector<ValueT<Tuple<UInt32, Ptr<Int32>>>> odd;
+    DeserializeIf<Owned, 0>(ownedBuffer.data(), odd, [](uint32_t id) { return id % 2 == 1; });
+
+    SERDES_CHECK(odd.size() == 2 && std::get<1>(odd[0]) != std::get<1>(odd[1]));
+    SERDES_CHECK(*std::get<1>(odd[0]) == 20 && *std::get<1>(odd[1]) == 40);
+    for(auto &record: odd)
+        delete std::get<1>(record);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of layout fingerprints and dispatching of message frames
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <stdexcept>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    using namespace serdes;
+
+    struct Point
+    {
+        int32_t x;
+        double y;
+    };
+
+    using PointSerdes = Struct<Point, Tuple<Int32, Double>, &Point::x, &Point::y>;
+
+    /// Message with the layout of UInt64 and its own fingerprint
+    struct Heartbeat : UInt64
+    {
+        static constexpr uint64_t fingerprint = 0x4842;
+    };
+
+    using Login = Tuple<String, UInt32>;
+    using Order = Tuple<UInt64, Double, Int32>;
+    using Cancel = UInt64;
+    using Other = Vector<String>;
+
+    struct Handler
+    {
+        size_t logins = 0;
+        size_t orders = 0;
+        uint64_t cancelled = 0;
+
+        void operator()(std::type_identity<Login>, ValueT<Login> &) { logins++; }
+        void operator()(std::type_identity<Order>, ValueT<Order> &) { orders++; }
+        void operator()(std::type_identity<Cancel>, ValueT<Cancel> &id) { cancelled += id; }
+    };
+
+    template<size_t ...I>
+    auto MakeArrayDispatcher(std::index_sequence<I...>) { return Dispatcher<Array<Int32, I + 1>...>{}; }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes::test;
+
+    // Fingerprints follow the wire layout
+    static_assert(Fingerprint<PointSerdes> == Fingerprint<Tuple<Int32, Double>>);
+    static_assert(Fingerprint<Int32, String> == Fingerprint<Tuple<Int32, String>>);
+    static_assert(Fingerprint<Int32> != Fingerprint<UInt32>);
+    static_assert(Fingerprint<Vector<UInt32>> != Fingerprint<Vector<UInt32B>>);
+    static_assert(Fingerprint<Vector<Int32>> != Fingerprint<Vector16<Int32>>);
+    static_assert(Fingerprint<Heartbeat> == 0x4842);
+
+    // Declared layout parameters are hashed; the chunk size of a Stream does not affect its readers
+    static_assert(Fingerprint<Chunked<UInt32, Int32, std::vector<int32_t>, 3>> != Fingerprint<Chunked<UInt32, Int32, std::vector<int32_t>, 4>>);
+    static_assert(Fingerprint<Stream<UInt32, Int32, std::vector<int32_t>, 3>> == Fingerprint<Stream<UInt32, Int32, std::vector<int32_t>, 4>>);
+
+    // Frames are dispatched by fingerprint; frames of unknown types are skipped
+    std::vector<uint8_t> data;
+    auto append = [&data](const std::vector<uint8_t> &frame) { data.insert(data.end(), frame.begin(), frame.end()); };
+    append(SerializeFrame<Login>(ValueT<Login>{"bob", 1}));
+    append(SerializeFrame<Other>(std::vector<std::string>{"zz"}));
+    append(SerializeFrame<Order>(ValueT<Order>{1, 2.0, 3}));
+    append(SerializeFrame<Cancel>(uint64_t{5}));
+    append(SerializeFrame<Cancel>(uint64_t{6}));
+
+    static_assert(Dispatcher<Login, Order, Cancel>::Find(Fingerprint<Other>) == -1);
+    static_assert(Dispatcher<Login, Order, Cancel>::Find(Fingerprint<Cancel>) == 2);
+
+    Dispatcher<Login, Order, Cancel> dispatcher;
+    Handler handler;
+
+    // An incomplete frame is left for the next call
+    const auto part = data.cend() - 3;
+    auto rest = dispatcher.DispatchAll(data.cbegin(), part, handler);
+    SERDES_CHECK(handler.logins == 1 && handler.orders == 1 && handler.cancelled == 5);
+    SERDES_CHECK(rest == data.cend() - static_cast<std::ptrdiff_t>(SizeofFrame<Cancel>(uint64_t{6})));
+
+    rest = dispatcher.DispatchAll(rest, data.cend(), handler);
+    SERDES_CHECK(rest == data.cend() && handler.cancelled == 11);
+
+    const auto other = data.cbegin() + SizeofFrame<Login>(ValueT<Login>{"bob", 1});
+    SERDES_CHECK(!dispatcher.Dispatch(other, data.cend(), handler).found);
+
+    // Messages with the same value type are told apart by the serdes tag
+    using Buy = Vector<UInt32>;
+    using Sell = Vector<UInt32B>;
+    auto orders = SerializeFrame<Buy>(std::vector<uint32_t>{1, 2});
+    const auto sell = SerializeFrame<Sell>(std::vector<uint32_t>{3});
+    orders.insert(orders.end(), sell.begin(), sell.end());
+
+    size_t bought = 0;
+    uint32_t sold = 0;
+    Dispatcher<Buy, Sell>().DispatchAll(orders.cbegin(), orders.cend(), [&]<typename T>(std::type_identity<T>, std::vector<uint32_t> &values)
+    {
+        if constexpr (std::same_as<T, Buy>)
+            bought += values.size();
+        else
+            sold += values[0];
+    });
+    SERDES_CHECK(bought == 2 && sold == 3);
+
+    // A frame whose length does not match the message is reported
+    auto corrupted = SerializeFrame<Order>(ValueT<Order>{1, 2.0, 3});
+    corrupted.push_back(0);
+    SerializeTo<UInt32>(corrupted.data(), Sizeof<Order>() + 1);
+    bool thrown = false;
+    try { (void)dispatcher.Dispatch(corrupted.cbegin(), corrupted.cend(), handler); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    // The perfect hash of many message types is found at compile time
+    using Arrays = decltype(MakeArrayDispatcher(std::make_index_sequence<60>{}));
+    static_assert(Arrays::Find(Fingerprint<Array<Int32, 17>>) == 16);
+
+    return 0;
+}
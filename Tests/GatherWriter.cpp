@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of scatter-gather serialization
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <thread>
+#include <ranges>
+#include <fcntl.h>
+#include <Serdes/Io/GatherWriter.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// Concatenation of the segments of the writer
+    std::vector<uint8_t> Gathered(const serdes::GatherWriter &writer)
+    {
+        std::vector<uint8_t> data;
+        for(const iovec &segment: writer.Iovecs())
+        {
+            const auto *begin = static_cast<const uint8_t *>(segment.iov_base);
+            data.insert(data.end(), begin, begin + segment.iov_len);
+        }
+        return data;
+    }
+
+    struct Name
+    {
+        int letter;
+    };
+
+    /// Custom serdes whose conversion returns a temporary string
+    using NameSerdes = serdes::Custom<Name, serdes::String,
+                                      [](const Name &name) { return std::string(10000, static_cast<char>('a' + name.letter)); },
+                                      [](std::string &&text, Name &name) { name.letter = text[0] - 'a'; }>;
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Large blocks are referenced in place, small pieces are coalesced
+    using Message = Tuple<UInt32, String, Vector<Double>, Vector<String>, Vector<UInt64B>>;
+    const std::string text(100000, 'x');
+    const std::vector<double> prices(50000, 1.5);
+    const std::vector<std::string> words{"a", std::string(5000, 'z'), "b"};
+    const std::vector<uint64_t> bigEndian(10000, 3);
+    const auto expected = Serialize<Message>(7u, text, prices, words, bigEndian);
+
+    GatherWriter writer;
+    SerializeTo<Message>(writer.begin(), 7u, text, prices, words, bigEndian);
+    SERDES_CHECK(writer.Size() == expected.size() && Gathered(writer) == expected);
+
+    const auto segments = writer.Iovecs();
+    SERDES_CHECK(std::ranges::any_of(segments, [&text](const iovec &segment) { return segment.iov_base == text.data(); }));
+    SERDES_CHECK(segments.size() < 10);
+
+    // Temporaries produced during serialization are copied before they are destroyed
+    using Generated = Tuple<NameSerdes, NameSerdes, Vector<String>>;
+    auto view = std::views::iota(0, 3) | std::views::transform([](int i) { return std::string(6000, static_cast<char>('0' + i)); });
+    const std::vector<std::string> viewCopy(view.begin(), view.end());
+    const auto generated = Serialize<Tuple<String, String, Vector<String>>>(std::string(10000, 'b'), std::string(10000, 'c'), viewCopy);
+
+    GatherWriter temporaries;
+    SerializeTo<Generated>(temporaries.begin(), Name{1}, Name{2}, view);
+    const std::vector<std::string> overwrite(20, std::string(10000, 'J'));
+    SERDES_CHECK(Gathered(temporaries) == generated);
+
+    // Writev to a slow non-blocking pipe waits instead of failing with EAGAIN
+    int pipefd[2];
+    SERDES_CHECK(::pipe(pipefd) == 0);
+    ::fcntl(pipefd[1], F_SETFL, O_NONBLOCK);
+    ::fcntl(pipefd[1], F_SETPIPE_SZ, 4096);
+
+    std::vector<uint8_t> received;
+    std::thread reader([&received, fd = pipefd[0]]
+    {
+        uint8_t chunk[512];
+        for(ssize_t n; (n = ::read(fd, chunk, sizeof(chunk))) > 0; ::usleep(50))
+            received.insert(received.end(), chunk, chunk + n);
+    });
+
+    SERDES_CHECK(writer.Writev(pipefd[1]) == expected.size());
+    ::close(pipefd[1]);
+    reader.join();
+    ::close(pipefd[0]);
+    SERDES_CHECK(received == expected);
+
+    // The writer can be reused after Clear
+    writer.Clear();
+    SerializeTo<String>(writer.begin(), std::string("five"));
+    SERDES_CHECK(Gathered(writer) == Serialize<String>(std::string("five")));
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the memory-mapped input file
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <fstream>
+#include <stdexcept>
+#include <Serdes/Io/MappedFile.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    using Values = Vector<UInt32>;
+    std::vector<uint32_t> values(100000);
+    for(uint32_t i = 0; i < values.size(); i++)
+        values[i] = i * 7;
+
+    const auto buffer = Serialize<Values>(values);
+    TempFile file;
+    std::ofstream(file.Path(), std::ios::binary).write(reinterpret_cast<const char *>(buffer.data()),
+                                                       static_cast<std::streamsize>(buffer.size()));
+
+    // The mapping is a contiguous input buffer
+    MappedFile mapped(file.Path(), {.advice = Advice::Sequential, .populate = true});
+    SERDES_CHECK(mapped.IsOpen() && mapped.size() == buffer.size());
+    SERDES_CHECK(std::equal(mapped.begin(), mapped.end(), buffer.begin()));
+
+    std::vector<uint32_t> result;
+    SERDES_CHECK(DeserializeFrom<Values>(mapped.data(), result) == mapped.end() && result == values);
+
+    SERDES_CHECK(mapped.Advise(Advice::Random));
+    SERDES_CHECK(mapped.Advise(Advice::WillNeed, 5000, 100));
+    SERDES_CHECK(!mapped.Advise(Advice::Normal, mapped.size()));
+
+    // Spans of regions are checked against the file size
+    SERDES_CHECK(mapped.Span(4, 8).data() == mapped.data() + 4);
+    bool thrown = false;
+    try { (void)mapped.Span(mapped.size() - 4, 5); } catch(const std::out_of_range &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    // Ownership of the mapping moves with the object
+    MappedFile moved = std::move(mapped);
+    SERDES_CHECK(moved.IsOpen() && !mapped.IsOpen() && mapped.data() == nullptr);
+    moved.Close();
+    SERDES_CHECK(!moved.IsOpen() && moved.size() == 0);
+
+    // An empty file is open and has no mapping
+    TempFile emptyFile;
+    MappedFile empty(emptyFile.Path());
+    SERDES_CHECK(empty.IsOpen() && empty.size() == 0 && empty.data() == nullptr && empty.Span().empty());
+
+    // Huge page aligned mapping
+#ifdef MADV_HUGEPAGE
+    MappedFile aligned(file.Path(), {.hugePageAligned = true});
+    SERDES_CHECK(reinterpret_cast<uintptr_t>(aligned.data()) % MappedFile::hugePageSize == 0);
+    SERDES_CHECK(std::equal(aligned.begin(), aligned.end(), buffer.begin()));
+#endif
+
+    // A missing file is reported with an exception
+    thrown = false;
+    try { MappedFile missing(file.Path() + ".missing"); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
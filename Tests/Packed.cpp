@@ -0,0 +1,69 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the frame-of-reference bit packing
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <list>
+#include <deque>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Values close to each other occupy a few bits
+    std::vector<uint32_t> quantities;
+    for(uint32_t i = 0; i < 1000; i++)
+        quantities.push_back(5000 + (i * 37) % 100);
+    CheckRoundTrip<PackedIntVector<UInt32>>(quantities);
+    SERDES_CHECK(PackedIntVector<UInt32>::Sizeof(quantities) < quantities.size());
+
+    // Every bit width, full and partial blocks
+    for(unsigned width = 0; width <= 64; width++)
+    {
+        std::vector<uint64_t> values;
+        for(uint64_t i = 0; i < 300; i++)
+            values.push_back(width == 0 ? 7 : width == 64 ? ~i : (i * 0x9E3779B97F4A7C15ull) >> (64 - width));
+        CheckRoundTrip<PackedIntVector<UInt64>>(values);
+    }
+
+    CheckRoundTrip<PackedIntVector<Int64>>({std::numeric_limits<int64_t>::min(), 0, std::numeric_limits<int64_t>::max()});
+    CheckRoundTrip<PackedIntVector<Int32>>({-5, -3, -4});
+    CheckRoundTrip<PackedIntVector<UInt32>>({});
+
+    // Non-contiguous ranges are packed with the same layout and unpacked through the block buffer
+    const std::list<uint32_t> list(quantities.begin(), quantities.end());
+    const auto buffer = Serialize<PackedIntVector<UInt32>>(quantities);
+    SERDES_CHECK(Serialize<PackedIntVector<UInt32>>(list) == buffer);
+    SERDES_CHECK(PackedIntVector<UInt32>::Sizeof(list) == buffer.size());
+
+    std::deque<uint32_t> deque;
+    DeserializeFrom<Packed<UInt32, UInt32, std::deque<uint32_t>>>(buffer.data(), deque);
+    SERDES_CHECK(std::ranges::equal(deque, quantities));
+
+    const std::list<uint8_t> bytes(buffer.begin(), buffer.end());
+    std::vector<uint32_t> fromList;
+    DeserializeFrom<PackedIntVector<UInt32>>(bytes.begin(), fromList);
+    SERDES_CHECK(fromList == quantities);
+
+    // Durations are packed as 64-bit integers
+    using Durations = Packed<UInt32, Pod<std::chrono::nanoseconds>, std::vector<std::chrono::nanoseconds>>;
+    CheckRoundTrip<Durations>({std::chrono::nanoseconds(-3), std::chrono::nanoseconds(1000), std::chrono::nanoseconds(7)});
+
+    // The block size is a part of the layout
+    static_assert(Fingerprint<Packed<UInt32, UInt32, std::vector<uint32_t>, 64>> != Fingerprint<PackedIntVector<UInt32>>);
+
+    // The incremental decoder scans one block at a time
+    CheckDecoder<PackedIntVector<UInt32>>(quantities);
+    CheckDecoder<PackedIntVector<UInt32>>({});
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of parallel serialization of ranges and parallel deserialization of chunked sequences
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <string>
+#include <stdexcept>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    /// Executor running the calls in order on the calling thread
+    struct SerialExecutor
+    {
+        size_t calls = 0;
+
+        template<typename TFunction>
+        void Bulk(size_t count, TFunction &&function)
+        {
+            for(size_t i = 0; i < count; i++, calls++)
+                function(i);
+        }
+    };
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<std::vector<std::string>> nested(20000);
+    for(size_t i = 0; i < nested.size(); i++)
+        for(size_t j = 0; j < i % 7; j++)
+            nested[i].push_back(std::string(j * 3 + i % 11, static_cast<char>('a' + j)));
+
+    // The result is identical to serial serialization for any number of threads
+    using Nested = Vector<Vector<String>>;
+    const auto serial = Serialize<Nested>(nested);
+
+    ThreadExecutor executor(4);
+    SERDES_CHECK(Serialize<Nested>(executor, nested) == serial);
+    SERDES_CHECK(Sizeof<Nested>(executor, nested) == serial.size());
+
+    std::vector<uint8_t> buffer(serial.size());
+    SERDES_CHECK(SerializeTo<Nested>(executor, buffer.begin(), nested) == buffer.end());
+    SERDES_CHECK(buffer == serial);
+
+    ThreadExecutor single(1);
+    SERDES_CHECK(Serialize<Nested>(single, nested) == serial);
+
+    SerialExecutor inOrder;
+    SERDES_CHECK(Serialize<Nested>(inOrder, nested) == serial && inOrder.calls > 0);
+
+    // Elements with a static buffer and empty ranges
+    const std::vector<int32_t> numbers(100000, 5);
+    SERDES_CHECK(Serialize<Vector<Int32>>(executor, numbers) == Serialize<Vector<Int32>>(numbers));
+    SERDES_CHECK(Serialize<Vector<Int32>>(executor, std::vector<int32_t>{}).size() == 4);
+
+    // Chunks of a chunked sequence are deserialized in parallel
+    using Strings = Chunked<UInt32, String, std::vector<std::string>, 16>;
+    std::vector<std::string> strings;
+    for(size_t i = 0; i < 1000; i++)
+        strings.push_back(std::string(i % 37, 's'));
+
+    auto chunked = Serialize<Strings>(strings);
+    std::vector<std::string> result;
+    SERDES_CHECK(DeserializeFrom<Strings>(executor, chunked.cbegin(), result) == chunked.cend());
+    SERDES_CHECK(result == strings);
+
+    std::vector<std::string> none;
+    const auto empty = Serialize<Strings>(none);
+    SERDES_CHECK(DeserializeFrom<Strings>(executor, empty.cbegin(), result) == empty.cend() && result.empty());
+
+    // A chunk whose data does not match its recorded length is reported
+    // (the last chunk is shortened, so that no chunk is decoded from a wrong position)
+    uint8_t *lastLength = chunked.data() + 4 * (strings.size() / 16 + (strings.size() % 16 != 0));
+    uint32_t length = 0;
+    DeserializeFrom<UInt32>(lastLength, length);
+    SerializeTo<UInt32>(lastLength, length - 1);
+    bool thrown = false;
+    try { DeserializeFrom<Strings>(executor, chunked.cbegin(), result); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    // The first exception thrown by a call is rethrown after all threads have finished
+    std::atomic<size_t> calls{0};
+    thrown = false;
+    try
+    {
+        executor.Bulk(100, [&](size_t i)
+        {
+            calls++;
+            if(i == 10)
+                throw std::invalid_argument("call 10");
+        });
+    }
+    catch(const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    SERDES_CHECK(thrown && calls > 10 && calls <= 100);
+
+    return 0;
+}
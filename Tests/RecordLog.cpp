@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the append-only record log: recovery, seeking and group commit
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <thread>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <Serdes/Io/RecordLog.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    using namespace serdes;
+
+    using Event = Tuple<UInt64, String>;
+
+    std::vector<uint8_t> ReadFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void WriteFile(const std::string &path, const std::vector<uint8_t> &data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    /// Event with a payload larger than the write buffer for every tenth number
+    ValueT<Event> MakeEvent(uint64_t id)
+    {
+        return {id, std::string(id % 10 == 0 ? 5000 : id % 23, static_cast<char>('a' + id % 26))};
+    }
+
+    /// Checks the records of a log sequentially and through the sparse index
+    void CheckLog(const std::string &path, uint64_t count, bool closed)
+    {
+        const RecordLogReader reader(path);
+        SERDES_CHECK(reader.Size() == count && reader.IsClosed() == closed);
+
+        uint64_t id = 0;
+        for(std::span<const uint8_t> payload: reader)
+        {
+            ValueT<Event> event;
+            Event::DeserializeFrom(payload.data(), event);
+            SERDES_CHECK(event == MakeEvent(id++));
+        }
+        SERDES_CHECK(id == count);
+
+        for(uint64_t i = count; i--;)
+        {
+            ValueT<Event> event;
+            reader.Read<Event>(i, event);
+            SERDES_CHECK(event == MakeEvent(i));
+            SERDES_CHECK(reader[i].size() == Event::Sizeof(event));
+        }
+
+        bool thrown = false;
+        try { (void)reader.Seek(count); } catch(const std::out_of_range &) { thrown = true; }
+        SERDES_CHECK(thrown);
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes::test;
+    using Format = details::LogFormat;
+
+    TempFile file;
+    const LogOptions options{.indexInterval = 4, .bufferSize = 4096};
+
+    // Records are assembled in the write buffer; large ones bypass it
+    {
+        RecordLogWriter writer(file.Path(), options);
+        for(uint64_t id = 0; id < 100; id++)
+            SERDES_CHECK(writer.Append<Event>(MakeEvent(id)) == id);
+
+        const auto payload = Serialize<Event>(MakeEvent(100));
+        SERDES_CHECK(writer.AppendBytes(payload) == 100);
+        writer.Close();
+
+        bool thrown = false;
+        try { (void)writer.Append<Event>(MakeEvent(101)); } catch(const std::logic_error &) { thrown = true; }
+        SERDES_CHECK(thrown);
+    }
+    CheckLog(file.Path(), 101, true);
+
+    // A closed log is reopened and appended to
+    {
+        RecordLogWriter writer(file.Path(), options);
+        SERDES_CHECK(writer.Size() == 101 && writer.DurableSize() == 101 && writer.TruncatedBytes() == 0);
+        for(uint64_t id = 101; id < 150; id++)
+            writer.Append<Event>(MakeEvent(id));
+    }
+    CheckLog(file.Path(), 150, true);
+
+    // A log that was not closed: the snapshot taken after Sync() has no footer
+    TempFile crashed;
+    {
+        RecordLogWriter writer(file.Path(), options);
+        for(uint64_t id = 150; id < 170; id++)
+            writer.Append<Event>(MakeEvent(id));
+        writer.Sync();
+        SERDES_CHECK(writer.DurableSize() == 170);
+        WriteFile(crashed.Path(), ReadFile(file.Path()));
+    }
+    CheckLog(crashed.Path(), 170, false);
+
+    // A torn record at the end is removed when the log is reopened
+    auto data = ReadFile(crashed.Path());
+    const size_t validSize = data.size();
+    const auto torn = Serialize<Format::PrefixSerdes>(100u, 0u);
+    data.insert(data.end(), torn.begin(), torn.end());
+    data.insert(data.end(), 10, 0xAB);
+    WriteFile(crashed.Path(), data);
+
+    SERDES_CHECK(Format::Parse(data.data(), data.size()).end == validSize);
+    {
+        RecordLogWriter writer(crashed.Path(), options);
+        SERDES_CHECK(writer.Size() == 170 && writer.TruncatedBytes() == torn.size() + 10);
+        writer.Append<Event>(MakeEvent(170));
+    }
+    CheckLog(crashed.Path(), 171, true);
+
+    // A corrupted record and everything after it are removed
+    WriteFile(crashed.Path(), std::vector<uint8_t>(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(validSize)));
+    const uint64_t corruptedOffset = RecordLogReader(crashed.Path()).Seek(60).Offset();
+    data.resize(validSize);
+    data[corruptedOffset + Format::prefixSize] ^= 1;
+    WriteFile(crashed.Path(), data);
+    {
+        const RecordLogReader reader(crashed.Path());
+        SERDES_CHECK(reader.Size() == 60 && !reader.IsClosed());
+    }
+    {
+        RecordLogWriter writer(crashed.Path(), options);
+        SERDES_CHECK(writer.Size() == 60 && writer.TruncatedBytes() == validSize - corruptedOffset);
+    }
+    CheckLog(crashed.Path(), 60, true);
+
+    // Records of a closed log are verified on access
+    data = ReadFile(crashed.Path());
+    data[corruptedOffset - 1] ^= 1;
+    WriteFile(crashed.Path(), data);
+    {
+        const RecordLogReader reader(crashed.Path());
+        SERDES_CHECK(reader.IsClosed() && reader.Size() == 60);
+        bool thrown = false;
+        try { (void)reader[59]; } catch(const std::runtime_error &) { thrown = true; }
+        SERDES_CHECK(thrown);
+        SERDES_CHECK(reader[58].size() == Event::Sizeof(MakeEvent(58)));
+    }
+
+    // Invalid headers
+    bool thrown = false;
+    try { (void)Format::Parse(data.data(), Format::headerSize - 1); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    data[0] ^= 1;
+    thrown = false;
+    try { (void)Format::Parse(data.data(), data.size()); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    // Group commit: records of all threads are durable after their Sync() calls
+    TempFile shared;
+    {
+        RecordLogWriter writer(shared.Path(), {.indexInterval = 16, .syncInterval = std::chrono::microseconds(500)});
+        std::vector<std::thread> threads;
+        for(uint64_t t = 0; t < 4; t++)
+            threads.emplace_back([&writer, t]
+            {
+                for(uint64_t i = 0; i < 50; i++)
+                {
+                    writer.Append<Event>(ValueT<Event>{t, "event"});
+                    if(i % 10 == 9)
+                        writer.Sync();
+                }
+            });
+        for(std::thread &thread: threads)
+            thread.join();
+
+        SERDES_CHECK(writer.Size() == 200 && writer.DurableSize() == 200);
+    }
+
+    // Records of a log are filtered by their key fields
+    std::vector<ValueT<Event>> selected;
+    DeserializeIf<Event, 0>(RecordLogReader(shared.Path()), selected, [](uint64_t thread) { return thread == 2; });
+    SERDES_CHECK(selected.size() == 50 && selected[0] == ValueT<Event>(2, "event"));
+
+    selected.clear();
+    DeserializeIf<Event, 0>(RecordLogReader(file.Path()), selected, [](uint64_t id) { return id % 10 == 0; });
+    SERDES_CHECK(selected.size() == 17 && selected[16] == MakeEvent(160));
+
+    return 0;
+}
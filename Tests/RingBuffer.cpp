@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the lock-free ring buffer of variable-length records
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <thread>
+#include <cstring>
+#include <stdexcept>
+#include <Serdes/Io/RingBuffer.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    using namespace serdes;
+
+    using Message = Tuple<UInt32, UInt32, String>;
+
+    /// Producers write numbered messages; the consumer checks that the messages of
+    /// every producer arrive complete and in order
+    template<RingProducers producers>
+    void CheckTransfer(uint32_t producerCount, size_t capacity, uint32_t count)
+    {
+        RingBuffer<producers> ring(capacity);
+        std::vector<std::jthread> threads;
+        for(uint32_t p = 0; p < producerCount; p++)
+            threads.emplace_back([&ring, p, count]
+            {
+                for(uint32_t i = 0; i < count; i++)
+                {
+                    const std::string text(i % 50, static_cast<char>('a' + p));
+                    while(!ring.template Write<Message>(p, i, text))
+                        std::this_thread::yield();
+                }
+            });
+
+        std::vector<uint32_t> next(producerCount, 0);
+        ValueT<Message> message;
+        for(uint64_t received = 0; received < uint64_t{count} * producerCount;)
+        {
+            if(!ring.template Read<Message>(message))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const auto &[producer, index, text] = message;
+            serdes::test::Check(producer < producerCount && index == next[producer]++, "message order", __FILE__, __LINE__);
+            serdes::test::Check(text == std::string(index % 50, static_cast<char>('a' + producer)), "message text", __FILE__, __LINE__);
+            received++;
+        }
+
+        threads.clear();
+        serdes::test::Check(ring.Empty(), "ring is empty", __FILE__, __LINE__);
+    }
+
+    template<typename TException, typename TFunction>
+    bool Throws(TFunction &&function)
+    {
+        try { function(); } catch(const TException &) { return true; }
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes::test;
+
+    // Small rings force frequent wrapping and padding records
+    CheckTransfer<RingProducers::Single>(1, 4096, 50000);
+    CheckTransfer<RingProducers::Multiple>(4, 1 << 16, 20000);
+    CheckTransfer<RingProducers::Multiple>(3, 256, 5000);
+
+    // Reservations: a record may be committed shorter than reserved
+    RingBuffer<RingProducers::Single> ring(64);
+    SERDES_CHECK(ring.MaxRecordSize() == 24);
+    SERDES_CHECK(Throws<std::length_error>([&] { (void)ring.Reserve(25); }));
+
+    auto reservation = ring.Reserve(20);
+    SERDES_CHECK(static_cast<bool>(reservation));
+    std::memset(reservation.begin(), 7, 20);
+    SERDES_CHECK(Throws<std::length_error>([&] { ring.Commit(reservation, 21); }));
+    ring.Commit(reservation, 5);
+
+    auto record = ring.Peek();
+    SERDES_CHECK(record && record.Data().size() == 5 && record.Data()[4] == 7);
+    ring.Release(record);
+    SERDES_CHECK(!ring.Peek() && ring.Empty());
+
+    // A full ring rejects records until the consumer releases space
+    uint64_t written = 0;
+    while(ring.Write<UInt64>(written))
+        written++;
+    SERDES_CHECK(written == 64 / 16);
+
+    uint64_t value = 1;
+    SERDES_CHECK(ring.Read<UInt64>(value) && value == 0);
+    SERDES_CHECK(ring.Write<UInt64>(written) && !ring.Write<UInt64>(written));
+
+    // Two views over the same memory: one creates the ring, the other attaches to it
+    alignas(64) static uint8_t memory[RingBuffer<RingProducers::Single>::RequiredSize(256)];
+    RingBuffer<RingProducers::Single> producer(memory, sizeof(memory), true);
+    RingBuffer<RingProducers::Single> consumer(memory, sizeof(memory), false);
+    producer.Write<Int32>(int32_t{42});
+    int32_t number = 0;
+    SERDES_CHECK(consumer.Read<Int32>(number) && number == 42);
+
+    // Invalid memory is rejected
+    SERDES_CHECK(Throws<std::invalid_argument>([] { RingBuffer<RingProducers::Single> invalid(100); }));
+    SERDES_CHECK(Throws<std::invalid_argument>([] { RingBuffer<RingProducers::Single> unaligned(memory + 8, sizeof(memory) - 8, true); }));
+    alignas(64) static uint8_t blank[RingBuffer<RingProducers::Single>::RequiredSize(256)];
+    SERDES_CHECK(Throws<std::invalid_argument>([] { RingBuffer<RingProducers::Single> unformatted(blank, sizeof(blank), false); }));
+
+    return 0;
+}
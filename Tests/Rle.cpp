@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the run-length encoding
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <string>
+#include <ranges>
+#include <Serdes/Io/GatherWriter.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Long runs are encoded as runs
+    std::vector<int32_t> states;
+    for(int i = 0; i < 10000; i++)
+        states.push_back(i / 1000);
+    CheckRoundTrip<Rle<Vector<Int32>>>(states);
+    SERDES_CHECK(Rle<Vector<Int32>>::Sizeof(states) < 128);
+
+    // Without runs the plain encoding is chosen, so the size grows only by the mode byte
+    std::vector<int32_t> distinct;
+    for(int i = 0; i < 1000; i++)
+        distinct.push_back(i);
+    CheckRoundTrip<Rle<Vector<Int32>>>(distinct);
+    SERDES_CHECK(Rle<Vector<Int32>>::Sizeof(distinct) == Vector<Int32>::Sizeof(distinct) + 1);
+
+    CheckRoundTrip<Rle<Vector<String>>>({"a", "a", "a", "b", "", "", "a"});
+    CheckRoundTrip<Rle<Vector<Int32>>>({});
+
+    // A GatherWriter copies the strings of a transform view, which are destroyed during serialization
+    using Names = Rle<Vector<String>>;
+    const auto names = std::views::iota(0, 3000)
+                       | std::views::transform([](int i) { return std::string(300, static_cast<char>('a' + i / 1000)); });
+    const std::vector<std::string> namesCopy(names.begin(), names.end());
+    const auto expected = Serialize<Names>(namesCopy);
+
+    GatherWriter writer(64);
+    SerializeTo<Names>(writer.begin(), names);
+    std::vector<uint8_t> gathered;
+    for(const iovec &segment: writer.Iovecs())
+        gathered.insert(gathered.end(), static_cast<const uint8_t *>(segment.iov_base), static_cast<const uint8_t *>(segment.iov_base) + segment.iov_len);
+    SERDES_CHECK(gathered == expected);
+
+    // The incremental decoder handles both layouts
+    CheckDecoder<Rle<Vector<Int32>>>(states);
+    CheckDecoder<Rle<Vector<Int32>>>(std::vector<int32_t>(distinct.begin(), distinct.begin() + 100));
+    CheckDecoder<Names>(namesCopy);
+    CheckDecoder<Rle<Vector<Int32>>>({});
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of ring buffers shared between processes
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <string>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <Serdes/Io/SharedRing.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    using namespace serdes;
+    using namespace std::chrono_literals;
+
+    using Message = Tuple<UInt32, UInt32, String>;
+
+    /// Runs the function in a child process
+    template<typename TFunction>
+    pid_t Fork(TFunction &&function)
+    {
+        const pid_t pid = ::fork();
+        if(pid == 0)
+        {
+            function();
+            ::_exit(0);
+        }
+        return pid;
+    }
+
+    /// Waits for a child process and checks that it has exited normally
+    bool Join(pid_t pid)
+    {
+        int status = 0;
+        return ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    /// Writes numbered messages, pausing now and then so that the consumer falls asleep
+    template<RingProducers producers>
+    void Produce(SharedRing<producers> &ring, uint32_t producer, uint32_t count)
+    {
+        for(uint32_t i = 0; i < count; i++)
+        {
+            while(!ring.template Write<Message>(producer, i, std::string(i % 40, 'q')))
+                ::usleep(1);
+            if(i % 5000 == 0)
+                ::usleep(20000);
+        }
+    }
+
+    /// Receives the messages of the producers and checks their order
+    template<RingProducers producers>
+    bool Consume(SharedRing<producers> &ring, uint32_t producerCount, uint32_t count)
+    {
+        std::vector<uint32_t> next(producerCount, 0);
+        ValueT<Message> message;
+        for(uint64_t received = 0; received < uint64_t{count} * producerCount; received++)
+        {
+            if(!ring.template Read<Message>(5s, message))
+                return false;
+
+            const auto &[producer, index, text] = message;
+            if(producer >= producerCount || index != next[producer]++ || text.size() != index % 40)
+                return false;
+        }
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes::test;
+
+    // Named ring: the producer process opens the ring created by the consumer
+    const std::string name = "/serdes-test-" + std::to_string(::getpid());
+    SharedRing<RingProducers::Single>::Unlink(name);
+    {
+        auto ring = SharedRing<RingProducers::Single>::Create(name, 1 << 12);
+        bool thrown = false;
+        try { (void)SharedRing<RingProducers::Single>::Create(name, 1 << 12); } catch(const std::runtime_error &) { thrown = true; }
+        SERDES_CHECK(thrown);
+
+        const pid_t pid = Fork([&name]
+        {
+            auto producer = SharedRing<RingProducers::Single>::Open(name);
+            Produce(producer, 0, 20000);
+        });
+
+        SERDES_CHECK(Consume(ring, 1, 20000));
+        SERDES_CHECK(Join(pid));
+
+        // Nothing more arrives: waits time out in both modes
+        SERDES_CHECK(!ring.Wait(10ms));
+        SERDES_CHECK(!ring.Wait(1ms, WaitMode::BusyPoll));
+    }
+    SERDES_CHECK(SharedRing<RingProducers::Single>::Unlink(name));
+
+    // Anonymous ring inherited by several producer processes
+    {
+        auto ring = SharedRing<RingProducers::Multiple>::CreateAnonymous(1 << 12);
+        std::vector<pid_t> pids;
+        for(uint32_t p = 0; p < 3; p++)
+            pids.push_back(Fork([&ring, p]
+            {
+                auto producer = SharedRing<RingProducers::Multiple>::Attach(ring.Fd());
+                Produce(producer, p, 10000);
+            }));
+
+        SERDES_CHECK(Consume(ring, 3, 10000));
+        for(pid_t pid: pids)
+            SERDES_CHECK(Join(pid));
+
+        // A busy-polling consumer receives a record written by another view
+        auto view = SharedRing<RingProducers::Multiple>::Attach(ring.Fd());
+        const pid_t pid = Fork([&view]
+        {
+            ::usleep(10000);
+            view.Write<Int32>(int32_t{7});
+        });
+        auto record = ring.Wait(5s, WaitMode::BusyPoll);
+        SERDES_CHECK(record && record.Data().size() == 4);
+        ring.Release(record);
+        SERDES_CHECK(Join(pid));
+
+        view.Write<Int32>(int32_t{8});
+        int32_t value = 0;
+        SERDES_CHECK(ring.Read<Int32>(0ns, value) && value == 8);
+    }
+
+    // Missing objects are rejected
+    bool thrown = false;
+    try { (void)SharedRing<RingProducers::Single>::Open("/serdes-test-missing"); } catch(const std::runtime_error &) { thrown = true; }
+    SERDES_CHECK(thrown);
+
+    return 0;
+}
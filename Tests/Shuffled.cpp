@@ -0,0 +1,65 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the byte-shuffle transform
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <list>
+#include <ranges>
+#include <Serdes/Io/GatherWriter.hpp>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<double> values;
+    std::vector<uint32_t> counters;
+    for(int i = 0; i < 3001; i++)
+    {
+        values.push_back(1.5 * i);
+        counters.push_back(static_cast<uint32_t>(i * 7));
+    }
+
+    CheckRoundTrip<Shuffled<Vector<Double>>>(values);
+    CheckRoundTrip<Shuffled<Vector<UInt32>>>(counters);
+    CheckRoundTrip<Shuffled<Vector<UInt64B>>>({1, 2, 0xFFFFFFFFFFFFFFFFull});
+    CheckRoundTrip<Shuffled<Vector<Double>>>({});
+
+    // The transform does not change the size
+    SERDES_CHECK(Shuffled<Vector<Double>>::Sizeof(values) == Vector<Double>::Sizeof(values));
+
+    // Non-contiguous input and output produce and accept the same bytes as the contiguous ones
+    using Doubles = Shuffled<Vector<Double>>;
+    const auto expected = Serialize<Doubles>(values);
+
+    const std::list<double> list(values.begin(), values.end());
+    SERDES_CHECK(Serialize<Doubles>(list) == expected);
+    SERDES_CHECK(Serialize<Doubles>(values | std::views::transform([](double x) { return x; })) == expected);
+
+    std::vector<uint8_t> appended;
+    SerializeTo<Doubles>(std::back_inserter(appended), values);
+    SERDES_CHECK(appended == expected);
+
+    std::list<double> restored;
+    SERDES_CHECK(DeserializeFrom<Doubles>(expected.cbegin(), restored) == expected.cend());
+    SERDES_CHECK(restored == list);
+
+    // A GatherWriter copies the shuffled block, which is released when SerializeTo returns
+    GatherWriter writer(64);
+    SerializeTo<Doubles>(writer.begin(), values);
+    std::vector<uint8_t> gathered;
+    for(const iovec &segment: writer.Iovecs())
+        gathered.insert(gathered.end(), static_cast<const uint8_t *>(segment.iov_base), static_cast<const uint8_t *>(segment.iov_base) + segment.iov_len);
+    SERDES_CHECK(gathered == expected);
+
+    // The incremental decoder waits for all shuffled bytes
+    CheckDecoder<Doubles>(std::vector<double>(values.begin(), values.begin() + 100));
+    CheckDecoder<Shuffled<Vector<UInt16>>>({});
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of streaming serialization of ranges of unknown size
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <list>
+#include <ranges>
+#include <sstream>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // A filtered view has no known size: the same chunks are produced for seekable and
+    // non-seekable output iterators
+    using Ints = StreamVector<Int32>;
+    std::vector<int32_t> numbers(10000);
+    for(int32_t i = 0; i < 10000; i++)
+        numbers[i] = i;
+
+    auto multiples = numbers | std::views::filter([](int32_t x) { return x % 3 == 0; });
+    const std::vector<int32_t> expected(multiples.begin(), multiples.end());
+
+    std::vector<uint8_t> buffer(Sizeof<Ints>(multiples));
+    SERDES_CHECK(SerializeTo<Ints>(buffer.begin(), multiples) == buffer.end());
+
+    std::vector<uint8_t> appended;
+    SerializeTo<Ints>(std::back_inserter(appended), multiples);
+    SERDES_CHECK(appended == buffer);
+
+    std::vector<int32_t> result;
+    SERDES_CHECK(DeserializeFrom<Ints>(buffer.cbegin(), result) == buffer.cend());
+    SERDES_CHECK(result == expected);
+    SERDES_CHECK(Skip<Ints>(buffer.cbegin()) == buffer.cend());
+
+    // An input range is consumed once; chunks hold at most chunkSize elements
+    using Small = Stream<UInt8, Int32, std::vector<int32_t>, 3>;
+    std::istringstream input("1 2 3 4 5 6 7");
+    std::vector<uint8_t> streamed;
+    SerializeTo<Small>(std::back_inserter(streamed), std::views::istream<int32_t>(input));
+    SERDES_CHECK(streamed.size() == (1 + 3 * 4) * 2 + (1 + 4) + 1);
+
+    std::vector<int32_t> read;
+    DeserializeFrom<Small>(streamed.begin(), read);
+    SERDES_CHECK((read == std::vector<int32_t>{1, 2, 3, 4, 5, 6, 7}));
+
+    // Elements with a dynamic buffer, deserialized into a list; an empty stream is the terminator only
+    using Strings = Stream<UInt16, String, std::list<std::string>, 2>;
+    CheckRoundTrip<Strings>({"a", "bb", "ccc", "dddd", "e"});
+    CheckRoundTrip<Strings>({});
+    SERDES_CHECK(Serialize<StreamVector<String>>(std::vector<std::string>{}).size() == 4);
+
+    // Decoding in fragments resumes at the chunk being received
+    CheckDecoder<Small>({1, 2, 3, 4, 5, 6, 7});
+    CheckDecoder<Strings>({"a", "bb", "ccc", "dddd", "e"});
+    CheckDecoder<Strings>({});
+    CheckDecoder<Ints>(expected);
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the varint serdes
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <limits>
+#include <initializer_list>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // Boundaries of the encoded lengths
+    for(uint64_t value: std::initializer_list<uint64_t>{0, 1, 127, 128, 16383, 16384, (uint64_t{1} << 56) - 1,
+                                                        uint64_t{1} << 63, std::numeric_limits<uint64_t>::max()})
+        CheckRoundTrip<VarUInt64>(value);
+
+    for(int64_t value: std::initializer_list<int64_t>{0, -1, 1, -64, 64, std::numeric_limits<int64_t>::min(),
+                                                      std::numeric_limits<int64_t>::max()})
+        CheckRoundTrip<VarInt64>(value);
+
+    CheckRoundTrip<VarUInt32>(std::numeric_limits<uint32_t>::max());
+    CheckRoundTrip<VarInt32>(std::numeric_limits<int32_t>::min());
+
+    // Small values occupy one byte, zigzag keeps small negative values small
+    SERDES_CHECK(VarUInt64::Sizeof(127) == 1 && VarUInt64::Sizeof(128) == 2);
+    SERDES_CHECK(VarInt64::Sizeof(-64) == 1 && VarInt64::Sizeof(-65) == 2);
+    SERDES_CHECK(VarUInt64::Sizeof(std::numeric_limits<uint64_t>::max()) == VarUInt64::Sizeof());
+
+    CheckRoundTrip<Vector<VarInt32>>({0, -1, 300, -70000, std::numeric_limits<int32_t>::max()});
+
+    // Zigzag encoding is a part of the layout
+    static_assert(Fingerprint<VarInt32> != Fingerprint<VarUInt32>);
+    static_assert(Fingerprint<VarInt32> == Fingerprint<Varint<int32_t>>);
+
+    // The incremental decoder resumes inside a varint
+    CheckDecoder<VarUInt64>(std::numeric_limits<uint64_t>::max());
+    CheckDecoder<VarInt64>(-1);
+    CheckDecoder<Tuple<VarInt32, String, Varint<uint16_t>>>({-70000, "text", 300});
+
+    return 0;
+}
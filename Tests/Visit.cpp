@@ -0,0 +1,73 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of element-by-element deserialization of ranges and streams
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <map>
+#include <string>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    std::vector<int32_t> numbers(1000);
+    for(int32_t i = 0; i < 1000; i++)
+        numbers[i] = i;
+
+    // Every element is visited; a callback returning bool stops at false and the rest is skipped
+    const auto buffer = Serialize<Vector<Int32>>(numbers);
+    int64_t sum = 0;
+    SERDES_CHECK(ForEachElement<Vector<Int32>>(buffer.cbegin(), [&](int32_t x) { sum += x; }) == buffer.cend());
+    SERDES_CHECK(sum == 499500);
+
+    size_t visited = 0;
+    SERDES_CHECK(ForEachElement<Vector<Int32>>(buffer.cbegin(), [&](int32_t x) { visited++; return x < 10; }) == buffer.cend());
+    SERDES_CHECK(visited == 11);
+
+    // Elements with a dynamic buffer: the position after the range is exact after stopping
+    using Index = Map<String, Vector<String>>;
+    const std::map<std::string, std::vector<std::string>> index{{"a", {"x", "y"}}, {"b", {}}, {"c", {"zz"}}};
+    auto indexBuffer = Serialize<Index>(index);
+    indexBuffer.push_back(7);
+
+    visited = 0;
+    auto end = ForEachElement<Index>(indexBuffer.cbegin(), [&](const auto &entry) { visited++; return entry.first != "a"; });
+    SERDES_CHECK(visited == 1 && end == indexBuffer.cend() - 1);
+
+    // Elements may be moved out of the reused element object
+    std::vector<std::pair<std::string, std::vector<std::string>>> entries;
+    auto [in, out] = DeserializeElements<Index>(indexBuffer.cbegin(), std::back_inserter(entries));
+    SERDES_CHECK(in == indexBuffer.cend() - 1);
+    SERDES_CHECK(entries.size() == 3 && entries[0].second == std::vector<std::string>{"x", "y"});
+    SERDES_CHECK(entries[1].second.empty() && entries[2].second == std::vector<std::string>{"zz"});
+
+    std::vector<std::string> moved;
+    ForEachElement<Vector<String>>(Serialize<Vector<String>>(std::vector<std::string>{"long string one", "two"}).cbegin(),
+                                   [&](std::string &s) { moved.push_back(std::move(s)); });
+    SERDES_CHECK((moved == std::vector<std::string>{"long string one", "two"}));
+
+    // Streams: visiting stops inside a chunk and the remaining chunks are skipped
+    using Ints = Stream<UInt16, Int32, std::vector<int32_t>, 100>;
+    const auto streamBuffer = Serialize<Ints>(numbers);
+
+    visited = 0;
+    SERDES_CHECK(ForEachElement<Ints>(streamBuffer.cbegin(), [&](int32_t) { return ++visited < 250; }) == streamBuffer.cend());
+    SERDES_CHECK(visited == 250);
+
+    std::vector<int32_t> copied;
+    SERDES_CHECK(DeserializeElements<Ints>(streamBuffer.cbegin(), std::back_inserter(copied)).in == streamBuffer.cend());
+    SERDES_CHECK(copied == numbers);
+
+    // Empty ranges and streams
+    visited = 0;
+    const auto empty = Serialize<Ints>(std::vector<int32_t>{});
+    SERDES_CHECK(ForEachElement<Ints>(empty.cbegin(), [&](int32_t) { visited++; }) == empty.cend() && visited == 0);
+
+    return 0;
+}
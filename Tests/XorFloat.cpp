@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/** @file
+
+    @brief Tests of the XOR floating-point compression
+
+    @author Niraleks
+*/
+//------------------------------------------------------------------------------
+#include <bit>
+#include <cmath>
+#include <limits>
+#include "Common.hpp"
+
+//------------------------------------------------------------------------------
+namespace
+{
+    template<typename T>
+    auto BitPatterns(const std::vector<T> &values)
+    {
+        using Bits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+        std::vector<Bits> patterns;
+        for(T value: values)
+            patterns.push_back(std::bit_cast<Bits>(value));
+        return patterns;
+    }
+
+    /// Checks that the values are restored bit-exactly by DeserializeFrom and by the incremental decoder
+    template<serdes::CSerdes TSerdes>
+    void CheckBitExact(const serdes::ValueT<TSerdes> &values)
+    {
+        using namespace serdes;
+
+        const auto buffer = Serialize<TSerdes>(values);
+        ValueT<TSerdes> result;
+        SERDES_CHECK(DeserializeFrom<TSerdes>(buffer.cbegin(), result) == buffer.cend());
+        SERDES_CHECK(BitPatterns(result) == BitPatterns(values));
+        SERDES_CHECK(Skip<TSerdes>(buffer.cbegin()) == buffer.cend());
+
+        IncrementalDecoder<TSerdes> decoder;
+        for(uint8_t byte: buffer)
+            (void)decoder.Feed({&byte, 1});
+        SERDES_CHECK(decoder.Status().IsDone() && decoder.Size() == buffer.size());
+        SERDES_CHECK(BitPatterns(decoder.Value()) == BitPatterns(values));
+    }
+}
+
+//------------------------------------------------------------------------------
+int main()
+{
+    using namespace serdes;
+    using namespace serdes::test;
+
+    // A slowly changing series is compressed
+    std::vector<double> prices;
+    for(int i = 0; i < 5000; i++)
+        prices.push_back(100.0 + 0.25 * (i % 40));
+    CheckRoundTrip<XorFloatVector<Double>>(prices);
+    SERDES_CHECK(XorFloatVector<Double>::Sizeof(prices) < prices.size() * sizeof(double) / 2);
+
+    std::vector<float> samples;
+    for(int i = 0; i < 1000; i++)
+        samples.push_back(std::sin(static_cast<float>(i) / 10));
+    CheckRoundTrip<XorFloatVector<Float>>(samples);
+
+    // Special values are restored bit-exactly
+    CheckRoundTrip<XorFloatVector<Double>>({});
+    CheckRoundTrip<XorFloatVector<Double>>({0.0, -0.0, std::numeric_limits<double>::infinity(),
+                                            std::numeric_limits<double>::denorm_min(),
+                                            std::numeric_limits<double>::max(), 1.0, 1.0});
+
+    // NaN payloads, signaling NaNs and signed zeros keep their bit patterns
+    CheckBitExact<XorFloatVector<Double>>({std::bit_cast<double>(uint64_t{0x7FF8000000000001}),
+                                           std::bit_cast<double>(uint64_t{0xFFF8DEADBEEF0000}),
+                                           std::bit_cast<double>(uint64_t{0x7FF0000000000001}),
+                                           std::numeric_limits<double>::quiet_NaN(), 0.0, -0.0, -0.0, 0.0,
+                                           -std::numeric_limits<double>::quiet_NaN()});
+    CheckBitExact<XorFloatVector<Float>>({std::bit_cast<float>(uint32_t{0x7FC00123}), -0.0f, 0.0f,
+                                          std::bit_cast<float>(uint32_t{0xFF800001}), -0.0f});
+
+    // The incremental decoder resumes between bit fields
+    CheckDecoder<XorFloatVector<Double>>(std::vector<double>(prices.begin(), prices.begin() + 300));
+    CheckDecoder<XorFloatVector<Float>>(samples);
+    CheckDecoder<XorFloatVector<Double>>({});
+    CheckDecoder<XorFloatVector<Double>>({1.5});
+    CheckDecoder<Tuple<XorFloatVector<Float>, String>>({{1.0f, 1.0f, 2.0f}, "tail"});
+
+    return 0;
+}